@@ -2,6 +2,8 @@
 #define AUTOCONFIG_H
 
 #include <fstream>
+#include <chrono>
+#include <cstdint>
 #include "Self.h"
 #include "json.hpp"
 
@@ -42,11 +44,61 @@ namespace acm{
         TimeLimit, //> 时间限制
         MemLimit, //> 内存限制
         JudgeStatus, //> 判题状态
+        Compare_Mode, //> 比较模式 checker 检查器 token 进程内比较 float 进程内浮点误差比较
+        Abs_Eps, //> 浮点绝对误差
+        Rel_Eps, //> 浮点相对误差
+        Stream_Mode, //> 流式比较 true 边运行边比较
+        Gen_Batch, //> 生成器批量大小 1 关闭 0 自动调节
+        Pack_Size, //> 打包组数 1 关闭
+        Pack_Lines, //> 每个子测试的输出行数
+        Gen_Shared, //> 生成器编译为共享库 true 载入后fork运行
+        Validator_Service, //> 常驻验证器 true 一个进程验证多组数据
+        Validate_Warmup, //> 抽样验证前需要连续通过验证的组数 0 每组都验证
+        Seed_Base, //> 基准种子
+        Worker_Id, //> 当前worker编号
+        Worker_Count, //> worker总数
+        Seed_Chunk, //> 每次分配给worker的种子块大小
+        Seed_Pos, //> 当前worker已分配的种子数
+        Keep_Passed, //> 是否保留通过的数据文件 false 只保留种子记录
+        Dedup, //> 跳过重复的输入数据
+        Dedup_Limit, //> 去重精确集合的上限，超过后转为布隆过滤器
+        Size_Min, //> 数据规模下限
+        Size_Max, //> 数据规模上限，大于0时按规模从小到大调度生成器
+        Size_Buckets, //> 规模分档数
+        Size_Tests, //> 每档运行的组数
+        Gen_Portfolio, //> 额外的数据生成器及其侧重，按每秒发现的错误数分配运行次数
+        Gen_Stats, //> 各数据生成器的运行组数、错误数和耗时
+        Minimize, //> 记录错误样例前最小化输入
+        Minimize_Jobs, //> 最小化的并行线程数
+        Minimize_Limit, //> 最小化测试的候选数上限
+        Keep_Going, //> 出现失败后继续对拍，按特征分桶
+        Max_Tests, //> 继续对拍时最多运行的组数
+        Max_Time, //> 继续对拍时最多运行的秒数
+        Bucket_Samples, //> 每个失败桶保留的样例数
+        Coverage, //> 以边覆盖插桩编译测试代码，变异覆盖到新边的输入
+        Coverage_Mutate, //> 覆盖引导时变异输入的比例
+        Coverage_Corpus, //> 覆盖引导保留的输入数上限
+        Hunt_Rounds, //> 超时搜索的轮数
+        Hunt_Jobs, //> 超时搜索每轮并行评估的候选数
+        Candidates, //> 与测试代码一起对拍的候选解法
+        AC_Cache, //> AC代码输出缓存的大小上限(MB)，0表示不缓存
+        Replay_Jobs, //> 重放错误样例的并行线程数
+        Corpus_Store, //> 失败和覆盖到新边的数据压缩存入按内容寻址的语料库
     };
     // 配置类
+    // get()和operator[]返回可修改的引用，无法跟踪每次修改，因此以写入内容的哈希判断是否变化
     class AutoConfig{
         json _config;
         fs::path _filePath;
+        size_t _dumpNum=4;
+        // 上次写入(或读取)内容的哈希，内容不变时不写入
+        uint64_t _lastHash=0;
+        // 合并保存: 距上次写入的秒数或未写入的保存次数达到其一时写入，都为0时每次保存都写入
+        double _interval=0;
+        size_t _count=0;
+        // 未写入的保存次数
+        size_t _pending=0;
+        std::chrono::steady_clock::time_point _lastWrite=std::chrono::steady_clock::now();
     public:
         // 构造函数
         AutoConfig();
@@ -55,8 +107,16 @@ namespace acm{
         void set_path(const fs::path &file);
         // 检查配置文件是否存在且不为空
         bool exist();
-        // 保存到配置文件
+        // 保存到配置文件，设置了合并保存时可能推迟到之后的保存或flush()
         void save(size_t dumpNum=4);
+        // 设置合并保存的时间间隔(秒)和次数
+        void set_debounce(double seconds,size_t count);
+        // 立即写入，内容与上次写入相同时不写；先写入临时文件再改名，中断时不会留下不完整的文件
+        void flush();
+        // 是否有推迟的保存
+        bool pending() const;
+        // 析构时写入推迟的保存
+        ~AutoConfig();
         // 获取原数据
         json &get();
         // 操作符
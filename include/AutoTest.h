@@ -5,17 +5,67 @@
 #include <memory>
 #include <filesystem>
 #include <unordered_map>
+#include <deque>
+#include <chrono>
+#include <unordered_set>
+#include <thread>
+#include <map>
 #include "openai.hpp"
 #include "json.hpp"
 #include "loglib.hpp"
 #include "Process.h"
 #include "KeyCircle.h"
 #include "AutoConfig.h"
+#include "Judge.h"
+#include "Compare.h"
+#include "SharedLib.h"
+#include "SeedScheduler.h"
+#include "Hash.h"
+#include "SizeRamp.h"
+#include "Bandit.h"
+#include "Minimizer.h"
+#include "FailureBuckets.h"
+#include "Coverage.h"
+#include "SlowSearch.h"
+#include "OutputCache.h"
+#include "JsonlStore.h"
+#include "Corpus.h"
+#include "MappedFile.h"
+#include "GenBatch.h"
 
 namespace acm{
     using nlohmann::json;
     // 自动测试类
     class AutoTest{
+    public:
+        // 退出状态
+        struct Exit{
+            process::Status status;
+            int exit_code;
+        };
+        // 验证统计
+        struct ValidateStats{
+            // 实际验证的组数
+            int validated=0;
+            // 抽样跳过的组数
+            int skipped=0;
+            // 验证不通过的组数
+            int rejected=0;
+            // 验证器总耗时(秒)
+            double time=0;
+            // 按平均耗时估算节省的时间(秒)
+            double saved() const;
+        };
+        // 去重统计
+        struct DedupStats{
+            // 生成的组数
+            int generated=0;
+            // 重复而跳过的组数
+            int duplicates=0;
+            // 跳过率
+            double rate() const;
+        };
+    private:
         // 配置文件
         fs::path _path="./config";
         AutoConfig _setting;
@@ -49,18 +99,32 @@ namespace acm{
         void wfile(const fs::path &path,const string &code);
         // 读取文件
         string rfile(const fs::path &path);
-        // prompt
-        std::unordered_map<string,string> _prompt;
+        // prompt文件夹，各提示词第一次使用时才映射
+        fs::path _promptPath;
+        std::unordered_map<string,MappedFile> _prompt;
         // 加载Prompt
         void init_prompt(const fs::path &path="./config/prompt");
-        // AI对象
+        // 获取提示词，文件不存在时抛出异常
+        std::string_view get_prompt(const string &name);
+        // AI对象，第一次对话前才注册key并设置API地址
         openai::OpenAI _AI;
+        bool _aiReady=false;
+        // 初始化AI，不使用AI的命令不需要密钥
+        void init_ai();
         // docs tools
         json _tools;
-        // 历史记录
-        AutoConfig _history;
-        // 初始化系统提示词,以及初始化历史记录
+        // 历史记录，每行一条消息，只追加
+        JsonlStore _history;
+        // 内存中的对话，第_historySaved条之后的消息尚未写入文件
+        json _session;
+        size_t _historySaved=0;
+        bool _sessionLoaded=false;
+        // 初始化历史记录
         void init_system();
+        // 对话，第一次使用时逐行读入历史记录，历史记录为空时加入系统提示词
+        json &get_session();
+        // 把新增的消息追加到历史记录
+        void save_history();
         // 对话
         json chat(const json &prompt,ConfigSign type=Model);
         // 获取题目名称
@@ -71,24 +135,185 @@ namespace acm{
         string check_func_call(const json &funcArgs,string &funcName);
         // 完全Ai，可以自动处理工具调用，可传入可选参数
         int AI(const string &prompt,json &session,ConfigSign useModel=Model);
-        // 文档内容
-        json _docs;
+        // 文档文件夹，各文档第一次使用时才映射
+        fs::path _docsPath;
+        std::unordered_map<string,MappedFile> _docs;
         // 初始化文档读取
         void init_docs(const fs::path &path="./config/docs");
         // 获取文档
         string get_docs(const string &DocsName);
         // 完整性验证
         bool full_check();
-        // 错误样例集合
-        AutoConfig _WAdatas;
+        // 错误样例集合，每行一个样例
+        JsonlStore _WAdatas;
+        // 打开错误样例集合，旧版本的WAdatas.json转为每行一个样例
+        void open_WAdatas();
         // 添加当前样例到错误集合
         void add_WAdatas();
+        // 比较模式，未设置时为checker
+        string compare_mode();
+        // 检查比较模式是否为checker、token或float之一，否则输出错误
+        bool check_compare_mode();
+        // 进程内比较当前样例的输出
+        JudgeCode compare();
+        // 按比较模式判定out与答案ac，检查器异常时返回Waiting；只读取参数，可在多个线程中调用
+        JudgeCode check_output(const fs::path &in,const fs::path &out,const fs::path &ac,const string &mode,double absEps,double relEps);
+        // 最近一次进程内比较的结果
+        CompareResult _lastCompare;
+        // 最近一次测试代码的waitpid状态
+        int _lastTestExit=0;
+        // 本次对拍的失败分桶
+        FailureBuckets _buckets;
+        // 当前失败数据的特征
+        string failure_signature();
+        // 记录当前失败，继续对拍时只保留每桶的前几个样例，返回是否结束对拍
+        bool record_failure();
         // cph路径
         fs::path _cph=".";
         // 设置cph路径
         bool set_cph(const fs::path &path);
+        // cph文件夹中第一个名字包含测试名的文件，没有时返回空
+        fs::path cph_file();
         // 修改源文件目录下.cph配置，将错误样例自动加入
         void add_to_cph();
+        // 共享库形式的数据生成器
+        process::SharedLib _genLib;
+        // 共享库是否已尝试载入
+        bool _genLoaded=false;
+        // 常驻的共享库形式的数据验证器
+        process::SharedLib _valLib;
+        bool _valLoaded=false;
+        // 首次使用时载入name的共享库版本，载入失败后不再尝试
+        bool load_shared(ConfigSign name,process::SharedLib &lib,bool &loaded);
+        // 以共享库运行数据生成器，共享库不可用时返回false
+        bool run_shared(const process::Args &args,const fs::path &output,const fs::path &workdir,Exit &res);
+        // 验证统计
+        ValidateStats _valStats;
+        // 自上次验证不通过以来的连续组数
+        int _valStreak=0;
+        // 抽样额度，累积到1时验证一组
+        double _valCredit=0;
+        // 上一组数据编号，编号不连续视为新的种子范围
+        int _valLastNum=-1;
+        // 抽样跳过验证、尚未得出结果的数据
+        std::unordered_set<string> _valSkipped;
+        // 本组数据是否需要验证
+        bool sample_validate(int num);
+        // 运行数据验证器并记录统计
+        Exit validate();
+        // 失败的数据如果跳过了验证则补充验证，不合法返回false
+        bool confirm_valid();
+        // 清空抽样状态，生成器或验证器变化后重新全部验证
+        void reset_sampling();
+        // 已测试输入的哈希
+        SeenSet _seen;
+        bool _seenReady=false;
+        // 去重统计
+        DedupStats _dedupStats;
+        // 当前数据是否与已测试的输入重复
+        bool is_duplicate();
+        // 自动对拍主循环
+        bool run_session();
+        // 输出本次对拍的统计
+        void report_session();
+        // 由常驻验证器验证input，共享库不可用时返回false
+        bool run_service(const fs::path &input,Exit &res);
+        // 种子调度
+        SeedScheduler _seeds;
+        bool _seedsReady=false;
+        // 各生成器的哈希
+        std::unordered_map<string,string> _genHash;
+        // 根据配置初始化种子调度
+        bool init_seeds();
+        // 规模调度
+        SizeRamp _ramp;
+        bool _rampReady=false;
+        // 根据配置初始化规模调度
+        bool init_ramp();
+        // AC代码的输出缓存，键为以AC代码哈希为种子的输入哈希
+        OutputCache _acCache;
+        uint64_t _acHash=0;
+        // 根据配置打开输出缓存
+        void init_ac_cache();
+        // 全局的语料库，各题目共用；本题存入的数据记录在corpus.jsonl中
+        Corpus _store;
+        JsonlStore _storeIndex;
+        // 根据配置打开语料库，未开启时返回false
+        bool init_corpus_store();
+        // 把数据的输入、输出和答案存入语料库，drop时删除原文件
+        void archive(const string &dataName,const string &kind,bool drop);
+        // 候选解法
+        struct Candidate{
+            string name;
+            // 本次对拍运行的组数和失败次数
+            long long runs=0,failures=0;
+            // 各失败状态的次数
+            std::map<string,long long> verdicts;
+            // 与测试代码同时运行的线程及其结果
+            std::thread worker;
+            Exit exit{ process::STOP,0 };
+        };
+        std::vector<Candidate> _candidates;
+        // 根据配置初始化候选解法，清空统计
+        void init_candidates();
+        // 在后台线程中运行每个候选解法
+        void launch_candidates(const string &dataName);
+        // 等待所有候选解法结束
+        void join_candidates();
+        // 与AC输出比较并统计，每个候选的前几个失败记录到错误集合
+        void judge_candidates(const string &dataName);
+        // 最小化失败数据，返回以同样状态失败的最小输入，无法缩小时返回空
+        string minimize_failure(const string &input,const string &status);
+        // 测试代码的边覆盖
+        CoverageMap _cov;
+        // 覆盖到新边的输入及其新覆盖数
+        std::vector<std::pair<string,size_t>> _corpus;
+        std::mt19937_64 _covRng;
+        // 当前数据是否由变异生成
+        bool _genMutant=false;
+        // 变异生成的组数，生成和变异的输入各自覆盖到新边的组数
+        long long _mutants=0,_generatedFinds=0,_mutantFinds=0;
+        // 编译插桩的测试代码并映射位图，失败时不使用覆盖引导
+        bool init_coverage();
+        // 并入本次运行的覆盖，覆盖到新边时把输入加入语料
+        void keep_coverage(const string &dataName);
+        // 按新覆盖数加权选择语料中的输入变异，输出到target
+        Exit gen_mutant(const string &dataName,const fs::path &target);
+        // 生成器组合，第0个为generators
+        std::vector<string> _arms;
+        Bandit _bandit;
+        bool _portfolioReady=false;
+        // 上一组数据的生成器
+        size_t _genArm=0;
+        // 数据对应的生成器，通过或记录错误后移除
+        std::unordered_map<string,size_t> _armOf;
+        // 根据配置初始化生成器组合，读取之前的统计
+        bool init_portfolio();
+        // 保存生成器组合的统计
+        void save_portfolio();
+        // 上一组数据开始生成的时间
+        std::chrono::steady_clock::time_point _genLast;
+        bool _genStarted=false;
+        // 结束上一组的计时，耗时计入其规模档和生成器，并开始本组计时
+        void lap();
+        // 生成器源码(不存在时为可执行文件)的哈希
+        const string &gen_hash(const string &gen);
+        // 记录数据对应的生成器、生成器哈希和种子
+        void record_seed(const string &dataName,const string &gen,long long seed,long long size);
+        // 以种子运行数据生成器gen，输出到target，size大于0时作为规模参数
+        Exit gen_seed(const string &gen,long long seed,long long size,const fs::path &target);
+        // 通过的数据只保留种子记录时删除数据文件
+        void passed(const string &dataName);
+        // 是否批量运行generators: gen_batch不为1且未启用生成器组合
+        bool use_batch();
+        // 批量运行数据生成器，取出种子seed的数据到target，left为种子块中剩余的连续种子数
+        Exit run_batch(long long seed,long long left,long long size,const fs::path &target);
+        // 批量生成的种子队列与批量大小调节
+        GenBatch _genBatch;
+        // 运行当前数据并进行进程内比较
+        bool judge_current(JudgeCode &code);
+        // 打包运行多组数据
+        bool run_pack(const std::vector<string> &names,JudgeCode &code);
     public:
         // 构造函数
         AutoTest(const string &name="");
@@ -114,23 +339,34 @@ namespace acm{
         // 设置AC代码
         bool set_ACCode(const string &code);
         bool set_ACCode(const fs::path &path);
+        // 添加候选解法，对拍时与测试代码同时运行同样的输入并与AC代码比较
+        bool add_candidate(const string &name,const fs::path &path);
         // 载入已经存在的文件夹
         bool load(const fs::path &path);
         // 初始化结构
         bool init();
-        // 测试工具生成编译
-        bool make(ConfigSign name,json &session);
+        // 测试工具生成编译，variant非空时生成侧重focus的另一个数据生成器
+        bool make(ConfigSign name,json &session,const string &variant=string(),const string &focus=string());
         // 生成测试工具
         AutoTest &gen();
-        // 退出状态
-        struct Exit{
-            process::Status status;
-            int exit_code;
-        };
         // 进行测试
         Exit run(ConfigSign name);
+        // 流式运行测试代码与AC代码并比较，AC代码异常返回false
+        bool run_stream(JudgeCode &code);
+        // 验证统计
+        const ValidateStats &get_validate_stats() const;
+        // 去重统计
+        const DedupStats &get_dedup_stats() const;
+        // 按种子记录重新生成数据到inData
+        bool regenerate(const string &dataName);
         // 开始自动对拍
         bool start();
+        // 搜索使测试代码CPU时间最长的种子与规模，找到超过时限的输入时返回true
+        bool hunt();
+        // 并行重放错误样例和cph中的测试，最近失败的优先；all为false时在第一个失败处结束，全部通过时返回true
+        bool replay(bool all=false);
+        // 从语料库中恢复数据的输入、输出和答案文件，找不到时返回false
+        bool restore(const string &dataName);
         // 析构函数
         ~AutoTest();
     };
@@ -0,0 +1,48 @@
+#ifndef BANDIT_H
+#define BANDIT_H
+
+#include "Self.h"
+#include <vector>
+#include <random>
+
+namespace acm{
+    // 多臂老虎机，按每秒发现的错误数在多个数据生成器之间分配运行次数
+    // 每个生成器的错误率 λ 的后验为 Gamma(1+bugs, prior+time)，每次从后验抽样取最大者(Thompson抽样)
+    class Bandit{
+    public:
+        // 单个生成器的统计
+        struct Arm{
+            // 运行组数
+            long long runs=0;
+            // 发现的错误数
+            long long bugs=0;
+            // 累计耗时(秒)
+            double time=0;
+            // 每秒发现的错误数
+            double yield() const;
+        };
+    private:
+        std::vector<Arm> _arms;
+        // 先验相当于每prior秒发现一个错误，避免没有错误时过早放弃
+        double _prior=1;
+        std::mt19937_64 _rng;
+    public:
+        // 构造函数，不启用
+        Bandit();
+        // 从已有统计继续，prior不为正时抛出异常
+        Bandit(std::vector<Arm> arms,double prior=1,uint64_t seed=std::random_device()());
+        // 是否启用(至少两个生成器)
+        bool enabled() const;
+        // 选择下一次运行的生成器，未运行过的优先
+        size_t select();
+        // 记录生成器的耗时
+        void record(size_t arm,double seconds);
+        // 记录生成器发现了一个错误
+        void bug(size_t arm);
+        // 生成器数量
+        size_t arms() const;
+        const Arm &arm(size_t i) const;
+    };
+}
+
+#endif // BANDIT_H
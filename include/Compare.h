@@ -0,0 +1,74 @@
+#ifndef COMPARE_H
+#define COMPARE_H
+
+#include "Self.h"
+
+namespace acm{
+    // 比较内核
+    enum CompareKernel{
+        Kernel_Auto, //> 运行时自动选择
+        Kernel_Scalar, //> 标量实现
+        Kernel_SSE42, //> SSE4.2
+        Kernel_AVX2, //> AVX2
+    };
+    // 比较结果
+    struct CompareResult{
+        // 是否一致
+        bool same=true;
+        // 第一个不同token的序号，从0开始
+        size_t token=0;
+        // 不同token在两个缓冲区中的起始偏移
+        size_t offsetA=0;
+        size_t offsetB=0;
+    };
+    // 忽略空白的token比较，返回第一个不同token的位置
+    CompareResult compare_tokens(const char *a,size_t lenA,const char *b,size_t lenB,CompareKernel kernel=Kernel_Auto);
+    CompareResult compare_tokens(const string &a,const string &b,CompareKernel kernel=Kernel_Auto);
+    // 浮点误差比较，数字token满足绝对或相对误差即视为相同，其余token逐字节比较
+    CompareResult compare_numbers(const char *a,size_t lenA,const char *b,size_t lenB,double absEps,double relEps,CompareKernel kernel=Kernel_Auto);
+    CompareResult compare_numbers(const string &a,const string &b,double absEps,double relEps,CompareKernel kernel=Kernel_Auto);
+    // 流式比较，两侧输出分块到达时增量比较，出现差异即可提前结束
+    class StreamCompare{
+        // 两侧尚未比较的数据
+        string _buf[2];
+        // 缓冲区中已比较的位置
+        size_t _pos[2]={ 0,0 };
+        // 当前token中两侧已确认相同的字节数，token未完整到达时下次从这里继续比较
+        size_t _checked=0;
+        // 缓冲区起点在整个输出中的偏移
+        size_t _base[2]={ 0,0 };
+        // 输出是否已经结束
+        bool _closed[2]={ false,false };
+        // 浮点模式
+        bool _float=false;
+        double _absEps=0,_relEps=0;
+        // 比较结论
+        bool _done=false;
+        CompareResult _res;
+        // 比较所有已到达的数据
+        void advance();
+        // 记录差异
+        void diverge(size_t i,size_t j);
+    public:
+        // 忽略空白的token比较
+        StreamCompare();
+        // 浮点误差比较
+        StreamCompare(double absEps,double relEps);
+        // 追加一侧(0 输出 1 答案)的数据，返回是否已得出结论
+        bool feed(int side,const char *data,size_t len);
+        // 一侧输出结束，返回是否已得出结论
+        bool close(int side);
+        // 是否已得出结论
+        bool done() const;
+        // 一侧已到达但尚未比较的字节数，调用方据此暂停读取领先的一侧
+        size_t pending(int side) const;
+        // 比较结果，只有done()后有效
+        const CompareResult &result() const;
+    };
+    // 当前CPU支持的最快内核
+    CompareKernel best_kernel();
+    // 内核名称
+    string f(CompareKernel kernel);
+}
+
+#endif // COMPARE_H
@@ -0,0 +1,47 @@
+#ifndef CORPUS_H
+#define CORPUS_H
+
+#include "Self.h"
+#include "JsonlStore.h"
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+
+namespace acm{
+    // 按内容寻址的压缩存储，每份内容以XXH64命名、zlib压缩后保存为objects/<前两位>/<哈希>
+    // 相同的内容只保存一次，可以在多个题目和多次对拍之间共用；index.jsonl记录每份内容的原始和压缩大小
+    class Corpus{
+        fs::path _dir;
+        JsonlStore _index;
+        // 已保存的内容及其原始大小
+        std::unordered_map<string,uint64_t> _sizes;
+        uint64_t _rawBytes=0,_packedBytes=0;
+        // 本次打开后put的次数和其中已存在的次数
+        long long _puts=0,_shared=0;
+        fs::path file_of(const string &hash) const;
+    public:
+        Corpus();
+        // 打开目录并读取索引，目录不存在时创建
+        void open(const fs::path &dir);
+        bool is_open() const;
+        // 保存内容，返回其哈希；已经存在时不再写入
+        string put(std::string_view data);
+        // 保存文件的内容
+        string put_file(const fs::path &file);
+        // 读取内容，不存在或已损坏时返回false
+        bool get(const string &hash,string &data) const;
+        bool contains(const string &hash) const;
+        // 保存的内容数、原始总大小和压缩后的总大小
+        size_t size() const;
+        uint64_t raw_bytes() const;
+        uint64_t packed_bytes() const;
+        // 本次打开后put的次数和其中已存在的次数
+        long long puts() const;
+        long long shared() const;
+        // 前8字节为小端序的原始大小，之后是zlib流
+        static string compress(std::string_view data);
+        static bool decompress(std::string_view packed,string &data);
+    };
+}
+
+#endif // CORPUS_H
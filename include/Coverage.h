@@ -0,0 +1,51 @@
+#ifndef COVERAGE_H
+#define COVERAGE_H
+
+#include "Self.h"
+#include <vector>
+#include <random>
+
+namespace acm{
+    // 边覆盖位图，由插桩后的测试代码通过共享映射的文件写入
+    // 测试代码以 -fsanitize-coverage=trace-pc 编译并链接runtime()，每个基本块把(上一块,本块)的边计入位图
+    class CoverageMap{
+    public:
+        // 位图大小，与runtime()中一致
+        static const size_t Size=1<<16;
+    private:
+        // 映射的位图文件
+        fs::path _file;
+        unsigned char *_map=nullptr;
+        // 每条边已见过的次数档位，每档一位
+        std::vector<unsigned char> _seen;
+        // 已见过的边数
+        size_t _edges=0;
+    public:
+        // 构造函数
+        CoverageMap();
+        // 禁止拷贝
+        CoverageMap(const CoverageMap &)=delete;
+        CoverageMap &operator=(const CoverageMap &)=delete;
+        // 创建并映射位图文件，失败抛出异常
+        void open(const fs::path &file);
+        void close();
+        bool is_open() const;
+        // 位图文件路径，通过环境变量ACM_COV_FILE传给测试代码
+        const fs::path &file() const;
+        // 位图数据
+        unsigned char *data();
+        // 运行前清空位图
+        void reset();
+        // 把本次运行的位图并入已见集合，返回新的(边,次数档位)数
+        size_t merge();
+        // 已见过的边数
+        size_t edges() const;
+        // 插桩运行时的源码，需要不插桩单独编译
+        static const char *runtime();
+        ~CoverageMap();
+    };
+    // 对输入做1到4次token级变异: 数字加减、取边界值、复制其他token、重复或删除一行
+    string mutate(const string &input,std::mt19937_64 &rng);
+}
+
+#endif // COVERAGE_H
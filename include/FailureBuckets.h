@@ -0,0 +1,49 @@
+#ifndef FAILUREBUCKETS_H
+#define FAILUREBUCKETS_H
+
+#include "Self.h"
+#include "Judge.h"
+#include "Compare.h"
+#include <map>
+#include <vector>
+#include <string_view>
+
+namespace acm{
+    // 失败分桶，按判题状态和特征(第一个不同token的位置和数值类型、信号)归类，每桶只保留少量样例
+    class FailureBuckets{
+    public:
+        // 一个桶
+        struct Bucket{
+            // 失败次数
+            long long count=0;
+            // 保留的样例数据名
+            std::vector<string> exemplars;
+        };
+    private:
+        std::map<string,Bucket> _buckets;
+        // 每桶保留的样例数
+        size_t _samples=3;
+        // 桶数上限，超过后新的特征只计数
+        size_t _limit=256;
+        // 总失败次数
+        long long _total=0;
+        // 因桶数超过上限未归类的失败次数
+        long long _overflow=0;
+    public:
+        // 构造函数
+        FailureBuckets(size_t samples=3,size_t limit=256);
+        // 记录一次失败，返回是否作为样例保留
+        bool add(const string &signature,const string &dataName);
+        const std::map<string,Bucket> &buckets() const;
+        long long total() const;
+        long long overflow() const;
+        // token的数值类型: 缺失 负数 零 正数 小数 字符串
+        static string token_class(std::string_view token);
+        // token序号的数量级: #0 #1 #2-3 #4-7 ...
+        static string position_class(size_t token);
+        // 失败特征，status为判题状态，exitCode为测试代码的waitpid状态，out和ac为两侧输出
+        static string signature(JudgeCode status,int exitCode,const CompareResult &cmp,std::string_view out,std::string_view ac);
+    };
+}
+
+#endif // FAILUREBUCKETS_H
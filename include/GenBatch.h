@@ -0,0 +1,47 @@
+#ifndef GENBATCH_H
+#define GENBATCH_H
+
+#include "Self.h"
+#include <deque>
+
+namespace acm{
+    // 批量生成的种子队列与批量大小调节
+    // 耗时模型 cost=启动开销+count*单组耗时，先测1组再测8组，调节后使启动开销占比不超过5%
+    class GenBatch{
+        // 已生成但未使用的种子
+        std::deque<long long> _queue;
+        // 队列中数据的规模
+        long long _size=0;
+        // 自动调节的批量大小
+        int _batch=1;
+        // 自动调节是否完成
+        bool _tuned=false;
+        // 单组批量的耗时(秒)
+        double _single=0;
+        // 调节得到的启动开销和单组耗时(秒)
+        double _overhead=0;
+        double _per=0;
+    public:
+        // 本批组数，fixed大于0时为固定批量，否则为自动调节的批量；一批不超过种子块中剩余的left个种子
+        int count(int fixed,long long left) const;
+        // 根据一批count组的耗时调节批量大小，返回是否刚完成调节
+        bool tune(int count,double cost);
+        // 是否完成调节
+        bool tuned() const;
+        // 调节得到的启动开销和单组耗时(秒)
+        double overhead() const;
+        double per() const;
+        // 队首是否为种子seed规模size的数据，否则需要重新生成一批
+        bool ready(long long seed,long long size) const;
+        // 记录新生成的一批: 种子seed到seed+count-1，规模size
+        void fill(long long seed,int count,long long size);
+        // 取出队首的种子
+        void pop();
+        // 清空队列，保留调节结果
+        void clear();
+        // 队列中剩余的组数
+        size_t pending() const;
+    };
+}
+
+#endif // GENBATCH_H
@@ -0,0 +1,55 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include "Self.h"
+#include <cstdint>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace acm{
+    // XXH64 哈希
+    uint64_t hash64(const void *data,size_t len,uint64_t seed=0);
+    uint64_t hash64(std::string_view data,uint64_t seed=0);
+    // 哈希的16位十六进制表示
+    string hex64(uint64_t hash);
+    // 已出现过的哈希集合，超过limit后转为可扩展的布隆过滤器以限制内存
+    // 过滤器分层，每层装满后追加一层容量翻倍、误判率更低的过滤器，总误判率不随元素数增长
+    class SeenSet{
+        // 精确集合
+        std::unordered_set<uint64_t> _exact;
+        // 精确集合的上限
+        size_t _limit;
+        // 布隆过滤器的一层
+        struct Layer{
+            std::vector<uint64_t> bits;
+            // 探测次数
+            int probes=4;
+            // 容量和已插入的元素数
+            size_t capacity=0;
+            size_t count=0;
+        };
+        std::vector<Layer> _layers;
+        // 插入的元素数
+        size_t _count=0;
+        // 追加一层布隆过滤器
+        void add_layer();
+        // 在某一层中查询，set为true时同时设置，返回是否已经存在
+        static bool probe(Layer &layer,uint64_t hash,bool set);
+        // 布隆过滤器中查询并插入，返回是否已经存在
+        bool bloom_insert(uint64_t hash);
+    public:
+        // 构造函数，limit为精确集合的上限
+        SeenSet(size_t limit=1<<20);
+        // 插入哈希，已经出现过返回false；布隆过滤器模式下有很小的概率误判为出现过
+        bool insert(uint64_t hash);
+        // 插入的元素数
+        size_t size() const;
+        // 是否已转为布隆过滤器
+        bool is_bloom() const;
+        // 清空
+        void clear();
+    };
+}
+
+#endif // HASH_H
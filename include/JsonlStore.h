@@ -0,0 +1,58 @@
+#ifndef JSONLSTORE_H
+#define JSONLSTORE_H
+
+#include "Self.h"
+#include "json.hpp"
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+namespace acm{
+    using nlohmann::json;
+    // 只追加的JSON Lines文件，每行一条记录，内存中只保存每条记录所在的位置
+    // 修改第i条记录时追加一行{"_replaces":i,"record":新记录}，打开时以最后一行为准
+    // 只修改部分字段时追加一行{"_updates":i,"fields":字段}，读取时按顺序合并到记录中
+    class JsonlStore{
+        struct Line{
+            uint64_t offset=0;
+            uint64_t length=0;
+            // 是否为替换记录的行
+            bool wrapped=false;
+        };
+        fs::path _path;
+        // 各条记录最新一行的位置
+        std::vector<Line> _index;
+        // 各条记录在最新一行之后的更新行
+        std::vector<std::vector<Line>> _updates;
+        // 文件大小
+        uint64_t _end=0;
+        // 追加一行，返回其位置
+        Line write_line(const string &line);
+        // 读取并解析一行
+        json read_line(std::istream &in,const Line &line) const;
+        // 读取第i条记录并合并更新
+        json read_record(std::istream &in,size_t i) const;
+    public:
+        JsonlStore();
+        // 打开文件并建立索引，文件不存在时创建；末尾不完整的一行(写入中断)被截掉
+        void open(const fs::path &file);
+        bool is_open() const;
+        const fs::path &path() const;
+        // 追加一条记录，返回其序号，只写入这一行；记录不能包含_replaces或_updates字段
+        size_t append(const json &record);
+        // 替换第i条记录
+        void replace(size_t i,const json &record);
+        // 更新第i条记录的部分字段，只写入这些字段
+        void update(size_t i,const json &fields);
+        // 记录数
+        size_t size() const;
+        bool empty() const;
+        // 读取第i条记录，只读取这一行；不修改状态，可在多个线程中调用
+        json at(size_t i) const;
+        json back() const;
+        // 按序号依次读取每条记录
+        void for_each(const std::function<void(size_t,const json &)> &visit) const;
+    };
+}
+
+#endif // JSONLSTORE_H
@@ -0,0 +1,40 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string_view>
+#include "Self.h"
+
+namespace acm{
+    // 只读内存映射文件，避免逐字符拷贝和二次缓冲
+    class MappedFile{
+        // 映射起点
+        char *_data=nullptr;
+        // 文件大小
+        size_t _size=0;
+        // 释放映射
+        void unmap();
+    public:
+        // 构造函数
+        MappedFile();
+        MappedFile(const fs::path &file);
+        // 禁止拷贝，允许移动
+        MappedFile(const MappedFile &)=delete;
+        MappedFile &operator=(const MappedFile &)=delete;
+        MappedFile(MappedFile &&other) noexcept;
+        MappedFile &operator=(MappedFile &&other) noexcept;
+        // 映射文件，失败抛出异常
+        void open(const fs::path &file);
+        // 关闭映射
+        void close();
+        // 数据指针，空文件为nullptr
+        const char *data() const;
+        // 文件大小
+        size_t size() const;
+        bool empty() const;
+        // 文件内容视图
+        std::string_view view() const;
+        ~MappedFile();
+    };
+}
+
+#endif // MAPPEDFILE_H
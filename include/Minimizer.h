@@ -0,0 +1,45 @@
+#ifndef MINIMIZER_H
+#define MINIMIZER_H
+
+#include "Self.h"
+#include <vector>
+#include <functional>
+
+namespace acm{
+    // 最小化粒度
+    enum Granularity{
+        Granularity_Line, //> 按行
+        Granularity_Token, //> 按token
+    };
+    // 并行的ddmin，把输入拆成行或token，删去尽可能多的部分后仍然失败
+    // 同一轮的候选在多个线程中同时测试，取序号最小的失败候选，结果与单线程一致
+    class Minimizer{
+    public:
+        // 候选是否仍然失败，worker为线程编号，不同线程可能同时调用
+        using Test=std::function<bool(const string &input,int worker)>;
+    private:
+        Test _test;
+        // 并行线程数
+        int _jobs=1;
+        // 候选测试次数上限，0表示不限制
+        long long _limit=0;
+        // 已测试的候选数
+        long long _tests=0;
+        // 按粒度拆分，拼接所有单元得到原输入
+        static std::vector<string> split(const string &input,Granularity granularity);
+        static string join(const std::vector<string> &units);
+        // 并行测试候选，返回序号最小的失败候选，都不失败时返回-1
+        long long first_failing(const std::vector<std::vector<string>> &candidates);
+        // 单一粒度的ddmin
+        std::vector<string> ddmin(std::vector<string> units);
+    public:
+        // jobs不为正时抛出异常
+        Minimizer(Test test,int jobs=1,long long limit=0);
+        // 最小化input，input本身应当失败
+        string minimize(const string &input,Granularity granularity);
+        // 已测试的候选数
+        long long tests() const;
+    };
+}
+
+#endif // MINIMIZER_H
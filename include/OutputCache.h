@@ -0,0 +1,48 @@
+#ifndef OUTPUTCACHE_H
+#define OUTPUTCACHE_H
+
+#include "Self.h"
+#include <cstdint>
+#include <unordered_map>
+
+namespace acm{
+    // 持久化的输出缓存，以输入的哈希为键，每个输出保存为目录中的一个文件
+    // 总大小超过上限时按最近使用时间淘汰，下次打开时以文件修改时间恢复使用顺序
+    class OutputCache{
+        struct Entry{
+            // 文件大小
+            uintmax_t size=0;
+            // 最近使用的序号
+            uint64_t tick=0;
+        };
+        fs::path _dir;
+        // 总大小上限(字节)，0表示不使用
+        uintmax_t _capacity=0;
+        uintmax_t _bytes=0;
+        uint64_t _tick=0;
+        std::unordered_map<uint64_t,Entry> _entries;
+        long long _hits=0,_misses=0,_evictions=0;
+        // 键对应的文件
+        fs::path file_of(uint64_t key) const;
+        // 淘汰最久未使用的输出，直到总大小不超过上限的9/10
+        void evict();
+    public:
+        OutputCache();
+        // 打开目录并读取已有的输出，超过上限时立即淘汰
+        void open(const fs::path &dir,uintmax_t capacity);
+        bool enabled() const;
+        // 命中时把输出复制到target并返回true
+        bool get(uint64_t key,const fs::path &target);
+        // 保存source作为key的输出，单个输出超过上限时不保存
+        void put(uint64_t key,const fs::path &source);
+        // 当前的输出数和总大小
+        size_t size() const;
+        uintmax_t bytes() const;
+        // 本次打开后的命中、未命中和淘汰次数
+        long long hits() const;
+        long long misses() const;
+        long long evictions() const;
+    };
+}
+
+#endif // OUTPUTCACHE_H
@@ -0,0 +1,14 @@
+#ifndef PACK_H
+#define PACK_H
+
+#include "Self.h"
+#include <vector>
+
+namespace acm{
+    // 打包运行失败后单独重跑子数据的顺序
+    // cases为各组数据的子测试数，line为答案中第一个差异之前的行数(未知时为负)，packLines为每个子测试的答案行数
+    // 按行号定位到的那组数据排在最前，其余按原顺序在后；pack_lines不准确时定位的那组可能单独通过，仍需重跑其余各组
+    std::vector<size_t> pack_order(const std::vector<long long> &cases,long long line,int packLines);
+}
+
+#endif // PACK_H
@@ -46,10 +46,16 @@ namespace process{
         bool _enable_color=false;
         // 退出状态
         int _exit_code=-1;
+        // 子进程的CPU时间(秒)
+        double _cpu_time=0;
         // 缓冲区大小
         int _buffer_size=4096;
         // 非阻塞超时
         int _flushTime=100;
+        // 标准输入输出重定向文件
+        string _inFile,_outFile;
+        // 工作目录
+        string _workDir;
         // 初始化管道
         void init_pipe();
         // 创建子进程并初始化
@@ -73,6 +79,8 @@ namespace process{
         Status wait();
         // 获得退出码
         int get_exit_code() const;
+        // 获得子进程的用户态与内核态CPU时间之和(秒)，wait之后有效
+        double get_cpu_time() const;
         // 获得退出状态
         Status get_status() const;
         // 读取数据
@@ -93,12 +101,18 @@ namespace process{
         bool kill(int signal=SIGKILL);
         // 流是否为空
         bool empty(PipeType type=PIPE_OUT);
+        // 获取管道句柄，用于多路复用
+        Handle get_handle(PipeType type=PIPE_OUT);
         // 设置阻塞状态
         void set_block(bool status);
         // 设置非阻塞超时时间
         void set_flush(int timeout_ms);
         // 设置管道缓冲区大小
         void set_buffer_size(size_t size);
+        // 重定向标准输入输出到文件
+        Process &set_redirect(PipeType type,const string &file);
+        // 设置子进程工作目录
+        Process &set_workdir(const string &dir);
         // 设置环境变量
         Process &set_env(const std::string &name,const std::string &value);
         // 获取环境变量
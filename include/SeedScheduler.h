@@ -0,0 +1,39 @@
+#ifndef SEEDSCHEDULER_H
+#define SEEDSCHEDULER_H
+
+#include "Self.h"
+
+namespace acm{
+    // 种子调度，多个worker按块交错分配互不相交的种子
+    // worker w 的第k块为 base+(k*workers+w)*chunk 起的chunk个种子
+    class SeedScheduler{
+        // 基准种子
+        long long _base=1;
+        // 当前worker编号
+        int _worker=0;
+        // worker总数
+        int _workers=1;
+        // 每块种子数
+        long long _chunk=1024;
+        // 已分配的种子数
+        long long _pos=0;
+    public:
+        // 构造函数，参数不合法时抛出异常
+        SeedScheduler();
+        SeedScheduler(long long base,int worker,int workers,long long chunk,long long pos=0);
+        // 第pos个种子
+        long long seed_at(long long pos) const;
+        // 下一个种子
+        long long peek() const;
+        // 取出下一个种子
+        long long next();
+        // 当前块中剩余的连续种子数，包括下一个种子
+        long long remaining() const;
+        // 已分配的种子数，用于持久化
+        long long position() const;
+        // 种子所属的worker，不在任何块中返回-1
+        int owner(long long seed) const;
+    };
+}
+
+#endif // SEEDSCHEDULER_H
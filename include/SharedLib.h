@@ -0,0 +1,60 @@
+#ifndef SHAREDLIB_H
+#define SHAREDLIB_H
+
+#include "Self.h"
+#include "Args.h"
+#include "Process.h"
+#include <string_view>
+
+namespace process{
+    // 共享库形式的程序，由载入进程载入一次后每次运行只需fork，省去exec和动态链接的开销
+    // 共享库只在子进程中载入，其静态构造和析构(如testlib的检查)不会影响当前进程
+    class SharedLib{
+        // 共享库路径
+        string _path;
+        // 上次运行的退出状态
+        int _exit_code=-1;
+        // 载入进程及其请求和应答管道
+        pid_t _loaderPid=-1;
+        int _loaderIn=-1,_loaderOut=-1;
+        // 常驻进程及其请求和应答管道
+        pid_t _servicePid=-1;
+        int _request=-1,_reply=-1;
+        // 常驻进程已处理的输入数
+        int _served=0;
+        // 常驻进程处理多少组输入后重启，限制泄漏的累积
+        static const int _serviceLimit=4096;
+        // 创建一对请求和应答管道
+        void open_pipes(int request[2],int reply[2]);
+        // 载入进程的循环: 每个请求fork出子进程运行main，waitpid状态写回应答管道
+        [[noreturn]] void loader_loop(int request,int reply);
+        // 启动常驻进程
+        void start_service(Args &args);
+        // 常驻进程的循环: 读取一帧输入作为stdin调用main，返回值写回应答管道
+        [[noreturn]] void service_loop(Args &args,int request,int reply);
+    public:
+        // 构造函数
+        SharedLib();
+        SharedLib(const fs::path &file);
+        // 禁止拷贝
+        SharedLib(const SharedLib &)=delete;
+        SharedLib &operator=(const SharedLib &)=delete;
+        // 启动载入进程载入共享库并查找main，失败抛出异常
+        void open(const fs::path &file);
+        // 结束载入进程和常驻进程
+        void close();
+        // 是否已经载入
+        bool is_open() const;
+        // 在子进程中运行main，output非空时标准输出写入文件，workdir非空时切换工作目录
+        Status run(Args args,const fs::path &output=fs::path(),const fs::path &workdir=fs::path());
+        // 由常驻进程以input作为stdin运行main，常驻进程异常退出后下次调用时重启
+        Status serve(Args args,std::string_view input);
+        // 结束常驻进程
+        void stop_service();
+        // 获得退出码
+        int get_exit_code() const;
+        ~SharedLib();
+    };
+}
+
+#endif // SHAREDLIB_H
@@ -0,0 +1,45 @@
+#ifndef SIZERAMP_H
+#define SIZERAMP_H
+
+#include "Self.h"
+#include <vector>
+
+namespace acm{
+    // 数据规模调度，规模按几何级数从小到大分档，每档运行固定组数后进入下一档，最大档之后重新开始
+    class SizeRamp{
+        // 各档规模
+        std::vector<long long> _sizes;
+        // 每档运行的组数
+        int _tests=0;
+        // 当前档位
+        int _bucket=0;
+        // 当前档位本轮已完成的组数
+        int _done=0;
+        // 各档累计组数和耗时(秒)
+        std::vector<int> _count;
+        std::vector<double> _time;
+    public:
+        // 构造函数，不启用
+        SizeRamp();
+        // 规模从min到max分为buckets档，参数不合法时抛出异常
+        SizeRamp(long long min,long long max,int buckets,int tests);
+        // 是否启用
+        bool enabled() const;
+        // 当前规模
+        long long size() const;
+        // 当前档位
+        int bucket() const;
+        // 当前档位本轮剩余组数
+        int remaining() const;
+        // 记录当前档位完成一组及其耗时，并推进档位
+        void record(double seconds);
+        // 档位数
+        size_t buckets() const;
+        // 第i档的规模、累计组数、耗时
+        long long size_of(size_t i) const;
+        int count_of(size_t i) const;
+        double time_of(size_t i) const;
+    };
+}
+
+#endif // SIZERAMP_H
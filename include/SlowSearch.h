@@ -0,0 +1,51 @@
+#ifndef SLOWSEARCH_H
+#define SLOWSEARCH_H
+
+#include "Self.h"
+#include <vector>
+#include <random>
+#include <functional>
+
+namespace acm{
+    // 并行爬山搜索使测试代码最慢的生成器种子与规模
+    // 每轮在当前最慢的候选附近取若干候选同时评估，更慢则移动过去；不设规模时只能换种子随机搜索
+    class SlowSearch{
+    public:
+        // 候选输入
+        struct Candidate{
+            long long seed=0;
+            // 规模，0表示不传规模参数
+            long long size=0;
+            // 代价(秒)，负数表示尚未评估或无效
+            double cost=-1;
+        };
+        // 评估候选并返回代价，负数表示无效(如验证不通过)；worker为线程编号，不同线程可能同时调用
+        using Eval=std::function<double(long long seed,long long size,int worker)>;
+    private:
+        Eval _eval;
+        // 每轮的候选数，即并行线程数
+        int _jobs=1;
+        // 规模范围，_sizeMax为0表示不设规模
+        long long _sizeMin=0,_sizeMax=0;
+        // 规模扰动的对数步长，没有改进时缩小
+        double _step=0.5;
+        std::mt19937_64 _rng;
+        Candidate _best;
+        long long _evaluations=0;
+        // 随机候选，规模偏向上限
+        Candidate random_candidate();
+        // 当前最优附近的候选: 保持种子改变规模，或保持规模换种子
+        Candidate neighbour();
+    public:
+        // jobs不为正或规模范围非法时抛出异常
+        SlowSearch(Eval eval,int jobs=1,long long sizeMin=0,long long sizeMax=0,uint64_t seed=std::random_device{}());
+        // 进行一轮搜索，返回目前最慢的候选
+        const Candidate &step();
+        // 目前最慢的候选，cost为负表示还没有有效候选
+        const Candidate &best() const;
+        // 已评估的候选数
+        long long evaluations() const;
+    };
+}
+
+#endif // SLOWSEARCH_H
@@ -1,7 +1,47 @@
 #include <iostream>
 #include "AutoTest.h"
 
-int main(){
+// 命令行用法
+static void usage(){
+    std::cout<<
+        "用法:\n"
+        "  main                        交互式配置，由AI生成测试工具后开始对拍\n"
+        "  main start <测试文件夹>     使用已编译的测试工具直接对拍，不使用AI\n"
+        "  main replay <测试文件夹> [all]\n"
+        "                              重放错误样例和cph中的测试，加all时运行全部样例\n"
+        "  main hunt <测试文件夹>      搜索使测试代码超时的输入，找到时返回0\n"
+        "  main restore <测试文件夹> <数据名>\n"
+        "                              从语料库中恢复数据的输入、输出和答案文件\n";
+}
+// 不使用AI的命令: 载入已有文件夹后直接运行，不读取密钥、文档和提示词
+static int run_command(int argc,char **argv){
+    std::string command=argv[1];
+    bool all=argc>3&&std::string(argv[3])=="all";
+    if((command!="start"&&command!="replay"&&command!="hunt"&&command!="restore")||argc<3||(command=="restore"&&argc<4)){
+        usage();
+        return 1;
+    }
+    acm::AutoTest test;
+    if(!test.load(argv[2])){
+        return 1;
+    }
+    if(command=="replay"){
+        return test.replay(all)?0:1;
+    }
+    if(command=="hunt"){
+        return test.hunt()?0:1;
+    }
+    if(command=="restore"){
+        return test.restore(argv[3])?0:1;
+    }
+    test.start();
+    return 0;
+}
+
+int main(int argc,char **argv){
+    if(argc>1){
+        return run_command(argc,argv);
+    }
     acm::AutoTest test;
     // 是否进行一些基础的配置
     std::string config;
@@ -1,4 +1,5 @@
 #include "AutoConfig.h"
+#include "Hash.h"
 
 namespace acm{
     // 配置转换器
@@ -52,6 +53,86 @@ namespace acm{
             return "mem_limit";
         case JudgeStatus:
             return "judge_status";
+        case Compare_Mode:
+            return "compare_mode";
+        case Abs_Eps:
+            return "abs_eps";
+        case Rel_Eps:
+            return "rel_eps";
+        case Stream_Mode:
+            return "stream_mode";
+        case Gen_Batch:
+            return "gen_batch";
+        case Pack_Size:
+            return "pack_size";
+        case Pack_Lines:
+            return "pack_lines";
+        case Gen_Shared:
+            return "gen_shared";
+        case Validator_Service:
+            return "validator_service";
+        case Validate_Warmup:
+            return "validate_warmup";
+        case Seed_Base:
+            return "seed_base";
+        case Worker_Id:
+            return "worker_id";
+        case Worker_Count:
+            return "worker_count";
+        case Seed_Chunk:
+            return "seed_chunk";
+        case Seed_Pos:
+            return "seed_pos";
+        case Keep_Passed:
+            return "keep_passed";
+        case Dedup:
+            return "dedup";
+        case Dedup_Limit:
+            return "dedup_limit";
+        case Size_Min:
+            return "size_min";
+        case Size_Max:
+            return "size_max";
+        case Size_Buckets:
+            return "size_buckets";
+        case Size_Tests:
+            return "size_tests";
+        case Gen_Portfolio:
+            return "gen_portfolio";
+        case Gen_Stats:
+            return "gen_stats";
+        case Minimize:
+            return "minimize";
+        case Minimize_Jobs:
+            return "minimize_jobs";
+        case Minimize_Limit:
+            return "minimize_limit";
+        case Keep_Going:
+            return "keep_going";
+        case Max_Tests:
+            return "max_tests";
+        case Max_Time:
+            return "max_time";
+        case Bucket_Samples:
+            return "bucket_samples";
+        case Coverage:
+            return "coverage";
+        case Coverage_Mutate:
+            return "coverage_mutate";
+        case Coverage_Corpus:
+            return "coverage_corpus";
+        case Hunt_Rounds:
+            return "hunt_rounds";
+        case Hunt_Jobs:
+            return "hunt_jobs";
+        case Candidates:
+            return "candidates";
+        case AC_Cache:
+            return "ac_cache";
+        case Replay_Jobs:
+            return "replay_jobs";
+        case Corpus_Store:
+            return "corpus_store";
         default:
             throw std::runtime_error("未知配置项");
         }
@@ -64,6 +145,10 @@ namespace acm{
     }
     // 设置路径
     void AutoConfig::set_path(const fs::path &file){
+        // 推迟的保存属于原来的文件
+        if(_pending>0){
+            flush();
+        }
         _filePath=file;
         exist();
         std::ifstream configfile(_filePath);
@@ -75,9 +160,15 @@ namespace acm{
             }
             newFile.close();
             _config=json::object();
+            // 空文件与任何内容都不同
+            _lastHash=0;
         }
-        else
+        else{
             _config=json::parse(configfile);
+            // 读取的内容视为已经写入，保存未修改的内容时不重写文件
+            _lastHash=hash64(_config.dump(_dumpNum));
+        }
+        _pending=0;
     }
     // 检查配置文件是否存在且不为空
     bool AutoConfig::exist(){
@@ -97,12 +188,59 @@ namespace acm{
     }
     // 保存到配置文件
     void AutoConfig::save(size_t dumpNum){
-        std::ofstream file(_filePath,std::ios::out);
+        _dumpNum=dumpNum;
+        _pending++;
+        if(_interval<=0&&_count==0){
+            flush();
+            return;
+        }
+        std::chrono::duration<double> elapsed=std::chrono::steady_clock::now()-_lastWrite;
+        if((_count>0&&_pending>=_count)||(_interval>0&&elapsed.count()>=_interval)){
+            flush();
+        }
+    }
+    void AutoConfig::set_debounce(double seconds,size_t count){
+        _interval=seconds;
+        _count=count;
+    }
+    void AutoConfig::flush(){
+        _pending=0;
+        _lastWrite=std::chrono::steady_clock::now();
+        if(_filePath.empty()){
+            return;
+        }
+        string data=_config.dump(_dumpNum);
+        uint64_t hash=hash64(data);
+        if(hash==_lastHash&&fs::exists(_filePath)){
+            return;
+        }
+        fs::path temp=_filePath;
+        temp+=".tmp";
+        std::ofstream file(temp,std::ios::out|std::ios::trunc);
         if(!file.is_open()){
-            throw std::runtime_error("AutoConfig: 无法打开文件: "+_filePath.string());
+            throw std::runtime_error("AutoConfig: 无法打开文件: "+temp.string());
         }
-        file<<_config.dump(dumpNum);
+        file<<data;
         file.close();
+        if(!file){
+            throw std::runtime_error("AutoConfig: 写入文件失败: "+temp.string());
+        }
+        fs::rename(temp,_filePath);
+        _lastHash=hash;
+    }
+    bool AutoConfig::pending() const{
+        return _pending>0;
+    }
+    AutoConfig::~AutoConfig(){
+        // 析构函数不能抛出异常
+        try{
+            if(_pending>0){
+                flush();
+            }
+        }
+        catch(const std::exception &e){
+            std::cerr<<e.what()<<std::endl;
+        }
     }
     // 获取原数据
     json &AutoConfig::get(){
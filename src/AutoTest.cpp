@@ -1,8 +1,41 @@
 #include "AutoTest.h"
 #include "Judge.h"
+#include "Compare.h"
+#include "MappedFile.h"
+#include "Hash.h"
+#include "OutputCache.h"
+#include "Pack.h"
 #include "fstream"
+#include <poll.h>
+#include <chrono>
+#include <cmath>
+#include <charconv>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <ctime>
+#include <csignal>
 
 namespace acm{
+    // 运行状态转换为判题结果，正常结束返回Waiting
+    static JudgeCode verdict(process::Status status,int exitCode){
+        if(status==process::STOP){
+            return Waiting;
+        }
+        JudgeCode temp=judge(status,exitCode);
+        return temp==Waiting?RuntimeError:temp;
+    }
+    // 启动各阶段的耗时，以DEBUG级别输出到日志
+    struct StageTimer{
+        std::chrono::steady_clock::time_point begin=std::chrono::steady_clock::now();
+        string cost;
+        // 结束一个阶段并开始下一个
+        void lap(const string &stage){
+            auto now=std::chrono::steady_clock::now();
+            cost+=" "+stage+" "+std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(now-begin).count())+"us";
+            begin=now;
+        }
+    };
     void AutoTest::wfile(const fs::path &path,const string &code){
         // 检查路径上的所有目录是否存在
         if(!fs::exists(path.parent_path())){
@@ -21,20 +54,35 @@ namespace acm{
             _log.tlog("文件不存在: "+path.string(),loglib::ERROR);
             return "";
         }
-        std::ifstream file(path);
-        if(!file.is_open()){
-            throw std::runtime_error("无法打开文件: "+path.string());
-        }
-        string code((std::istreambuf_iterator<char>(file)),std::istreambuf_iterator<char>());
-        file.close();
-        return code;
+        // 内存映射后一次性拷贝
+        MappedFile file(path);
+        return string(file.view());
     }
     // 获取文档
     string AutoTest::get_docs(const string &DocsName){
-        if(_docs.find(DocsName)==_docs.end()){
-            return "文档不存在: "+DocsName;
+        // 工具说明中的文档名对应Testlib_*.md，也可以用其余文档的文件名
+        static const std::unordered_map<string,string> files={
+            { "Total","Testlib_Total.md" },
+            { "Generators","Testlib_Generators.md" },
+            { "Validators","Testlib_Validators.md" },
+            { "Checkers","Testlib_Checkers.md" },
+            { "Interactors","Testlib_Interactors.md" },
+            { "index","index.md" },
+            { "general","general.md" },
+            { "generator","generator.md" },
+            { "validator","validator.md" },
+            { "checker","checker.md" },
+            { "interactor","interactor.md" }
+        };
+        auto doc=_docs.find(DocsName);
+        if(doc==_docs.end()){
+            auto file=files.find(DocsName);
+            if(file==files.end()||!fs::exists(_docsPath/file->second)){
+                return "文档不存在: "+DocsName;
+            }
+            doc=_docs.emplace(DocsName,MappedFile(_docsPath/file->second)).first;
         }
-        return _docs[DocsName];
+        return string(doc->second.view());
     }
     // 新增工具
     void AutoTest::add_tool(const json &tool){
@@ -42,6 +90,9 @@ namespace acm{
     }
     // 对话
     json AutoTest::chat(const json &prompt,ConfigSign type){
+        if(!_aiReady){
+            init_ai();
+        }
         if(type==Model){
             // 发送请求
             return _AI.chat.create({
@@ -122,7 +173,7 @@ namespace acm{
             _log.tlog("正在自动命名");
             json prompt=json::array({
                 { "role","user" },
-                { "content",_prompt["askname"]+_problem }
+                { "content","你是一个自动命名器,请根据题面生成一个合适的题目名称。请你的回复JSON格式为:{\"name\":\"题目名称\"}。题面："+_problem }
                 });
             json result=chat(prompt,Named_Model);
             json resultData=result["choices"][0]["message"]["content"];
@@ -188,6 +239,25 @@ namespace acm{
             set_key();
         }
     }
+    // 初始化AI，非附加模式使用测试文件夹中的密钥和API地址
+    void AutoTest::init_ai(){
+        string url=_setting[f(OpenAI_URL)];
+        if(!_config.get().value(f(Attach_Global),true)){
+            _log.tlog("附加模式为false");
+            _openaiKey.set_path(_basePath/"openai.key");
+            url=_config.get().value(f(OpenAI_URL),string());
+            if(url.empty()){
+                _log.tlog("OpenAI API地址为空,使用默认地址",loglib::WARNING);
+                url="https://api.openai.com/v1";
+                _config[f(OpenAI_URL)]=url;
+                _config.save();
+            }
+        }
+        init_key();
+        _AI.setBaseUrl(url);
+        _AI.setToken(_openaiKey.get());
+        _aiReady=true;
+    }
     // 配置文件初始化
     void AutoTest::init_config(){
         if(!_setting.exist()){
@@ -258,56 +328,89 @@ namespace acm{
             _config.save();
         }
     }
-    // 初始化文档读取
+    // 初始化文档读取，文档在get_docs中第一次使用时才映射
     void AutoTest::init_docs(const fs::path &path){
         if(!fs::exists(path)){
-            throw std::runtime_error("文档文件夹不存在: "+path.string());
-        }
-        // 初始化文档文件夹
-        _log.tlog("正在读取Testlib文档");
-        // 读取文档
-        auto &_docs_origin=_docs["origin"];
-        _docs_origin["Total"]=rfile(path/"Testlib_Total.md");
-        _docs_origin[f(Generators)]=rfile(path/"Testlib_Generators.md");
-        _docs_origin[f(Validators)]=rfile(path/"Testlib_Validators.md");
-        _docs_origin[f(Checkers)]=rfile(path/"Testlib_Checkers.md");
-        _docs_origin[f(Interactors)]=rfile(path/"Testlib_Interactors.md");
-        auto &_docs_new=_docs["new"];
-        _docs_new["index"]=rfile(path/"index.md");
-        _docs_new["general"]=rfile(path/"general.md");
-        _docs_new[f(Generators)]=rfile(path/"generator.md");
-        _docs_new[f(Validators)]=rfile(path/"validator.md");
-        _docs_new[f(Checkers)]=rfile(path/"checker.md");
-        _docs_new[f(Interactors)]=rfile(path/"interactor.md");
-    }
-    // 加载Prompt
+            _log.tlog("文档文件夹不存在: "+path.string(),loglib::WARNING);
+        }
+        _docsPath=path;
+        _docs.clear();
+    }
+    // 加载Prompt，提示词在第一次使用时才映射
     void AutoTest::init_prompt(const fs::path &path){
         if(!fs::exists(path)){
-            throw std::runtime_error("Prompt文件夹不存在: "+path.string());
+            _log.tlog("Prompt文件夹不存在: "+path.string(),loglib::WARNING);
+        }
+        _promptPath=path;
+        _prompt.clear();
+    }
+    std::string_view AutoTest::get_prompt(const string &name){
+        static const std::unordered_map<string,string> files={
+            { f(Generators),"GeneratePrompt.md" },
+            { f(Validators),"ValidatePrompt.md" },
+            { f(Checkers),"CheckPrompt.md" },
+            { "system","System.md" }
+        };
+        auto prompt=_prompt.find(name);
+        if(prompt==_prompt.end()){
+            auto file=files.find(name);
+            if(file==files.end()){
+                throw std::runtime_error("未知的Prompt: "+name);
+            }
+            if(!fs::exists(_promptPath/file->second)){
+                throw std::runtime_error("Prompt文件不存在: "+(_promptPath/file->second).string());
+            }
+            prompt=_prompt.emplace(name,MappedFile(_promptPath/file->second)).first;
         }
-        // 初始化Prompt文件夹
-        _log.tlog("正在读取Prompt");
-        // 读取Prompt
-        _prompt[f(Generators)]=rfile(path/"GeneratePrompt.md");
-        _prompt[f(Validators)]=rfile(path/"ValidatePrompt.md");
-        _prompt[f(Checkers)]=rfile(path/"CheckPrompt.md");
-        _prompt["system"]=rfile(path/"System.md");
-        _prompt["askname"]="你是一个自动命名器,请根据题面生成一个合适的题目名称。请你的回复JSON格式为:{\"name\":\"题目名称\"}。题面：";
+        return prompt->second.view();
     }
     // 初始化系统提示词
     void AutoTest::init_system(){
-        // 初始化系统提示词
-        _history.set_path(_basePath/"history.json");
-        if(!_history.exist()){
-            auto &history=_history.get();
-            history=json::array();
-            history.push_back({
-                { "role","system" },
-                { "content",_prompt["system"] }
-                });
-            _history.save();
+        // 之前的对话在第一次使用时才读入
+        _session=json::array();
+        _historySaved=0;
+        _sessionLoaded=false;
+        fs::path file=_basePath/"history.jsonl";
+        fs::path legacy=_basePath/"history.json";
+        bool fresh=!fs::exists(file);
+        _history.open(file);
+        if(fresh&&fs::exists(legacy)){
+            json old=json::parse(rfile(legacy),nullptr,false);
+            if(old.is_array()){
+                for(const auto &message:old){
+                    _history.append(message);
+                }
+                _log.tlog("已把history.json中的"+std::to_string(old.size())+"条消息转为history.jsonl");
+            }
+            fs::rename(legacy,_basePath/"history.json.bak");
+        }
+    }
+    json &AutoTest::get_session(){
+        if(!_sessionLoaded){
+            // 系统提示词在第一次对话时才读取
+            if(_history.empty()){
+                _history.append({
+                    { "role","system" },
+                    { "content",string(get_prompt("system")) }
+                    });
+            }
+            _session=json::array();
+            _history.for_each([&](size_t,const json &message){
+                _session.push_back(message);
+            });
+            _historySaved=_session.size();
+            _sessionLoaded=true;
+        }
+        return _session;
+    }
+    // 对话只在末尾追加，保存时只写入新的消息
+    void AutoTest::save_history(){
+        if(!_history.is_open()){
+            return;
+        }
+        for(;_historySaved<_session.size();_historySaved++){
+            _history.append(_session[_historySaved]);
         }
-
     }
     // 构造函数
     AutoTest::AutoTest(const string &name)
@@ -318,14 +421,25 @@ namespace acm{
         // 设置日志总配置
         _log.set_logName("AutoTest.log");
         _log.tlog("AutoTest开始运行");
+        // 忽略SIGPIPE(对整个进程生效): 流式比较、验证器和候选解法等子进程提前退出时，
+        // 向其管道写入只返回EPIPE，不应终止当前进程
+        struct sigaction ignore{};
+        ignore.sa_handler=SIG_IGN;
+        sigemptyset(&ignore.sa_mask);
+        sigaction(SIGPIPE,&ignore,nullptr);
+        // 对拍循环中每组数据都会多次保存测试配置，合并为每秒最多写入一次
+        _config.set_debounce(1.0,0);
+        StageTimer timer;
         // 配置文件初始化
         init_config();
-        // 注册key
-        init_key();
+        timer.lap("配置");
         // 默认文档读取
         init_docs(_path/"docs");
+        timer.lap("文档");
         // 默认prompt读取
         init_prompt(_path/"prompt");
+        timer.lap("提示词");
+        _log.tlog("启动耗时:"+timer.cost,loglib::DEBUG);
     }
     // 设置配置文件
     void AutoTest::config(const string key,const string value,ConfigSign target){
@@ -440,6 +554,34 @@ namespace acm{
         }
         return true;
     }
+    // 候选解法与测试代码一样保存在测试文件夹中，名字记录到配置
+    bool AutoTest::add_candidate(const string &name,const fs::path &path){
+        if(name.empty()||name.find('/')!=string::npos||name=="."||name==".."){
+            _log.tlog("候选解法名字不合法: "+name,loglib::ERROR);
+            return false;
+        }
+        if(!fs::exists(path)){
+            _log.tlog("候选解法文件不存在: "+path.string(),loglib::ERROR);
+            return false;
+        }
+        if(path.extension()!=".cpp"){
+            _log.tlog("候选解法文件格式错误: "+path.string(),loglib::ERROR);
+            return false;
+        }
+        fs::path target=_basePath/"candidates"/(name+".cpp");
+        fs::create_directories(target.parent_path());
+        fs::copy_file(path,target,fs::copy_options::overwrite_existing);
+        json &list=_config[f(Candidates)];
+        if(!list.is_array()){
+            list=json::array();
+        }
+        if(std::find(list.begin(),list.end(),name)==list.end()){
+            list.push_back(name);
+        }
+        _config.save();
+        _log.tlog("已添加候选解法: "+name);
+        return true;
+    }
     bool AutoTest::set_cph(const fs::path &path){
         // 检查文件夹是否存在
         if(!fs::exists(path)){
@@ -556,19 +698,13 @@ namespace acm{
         _testlog.tlog("文件写入成功");
         // 初始化测试配置
         init_test_config();
-        // 初始化AI - 构造
-        _AI.setToken(_openaiKey.get());
-        _AI.setBaseUrl(_setting[f(OpenAI_URL)]);
+        // AI在第一次对话时初始化
+        _aiReady=false;
         _log.tlog("初始化成功,文件夹在: "+_basePath.string());
         // 初始化历史记录
         init_system();
         // 初始化错误样例集合
-        _WAdatas.set_path(_basePath/"WAdatas.json");
-        if(!_WAdatas.exist()){
-            _log.tlog("正在初始化错误样例集合");
-            _WAdatas.get()=json::array();
-            _WAdatas.save();
-        }
+        open_WAdatas();
         return true;
     }
     // 载入已经存在的文件夹
@@ -577,7 +713,16 @@ namespace acm{
             _log.tlog("指定路径不存在,请检查路径",loglib::ERROR);
             return false;
         }
+        StageTimer timer;
         _basePath=path;
+        // 种子调度和生成器哈希随题目重新读取
+        _seedsReady=false;
+        _rampReady=false;
+        _portfolioReady=false;
+        _genStarted=false;
+        _armOf.clear();
+        _genHash.clear();
+        _genBatch.clear();
         _problemfile=_basePath/"problem.md";
         _testfile=_basePath/"test.cpp";
         _ACfile=_basePath/"AC.cpp";
@@ -611,37 +756,22 @@ namespace acm{
         // 读入日志文件
         _testlog.set_logPath(_basePath);
         _testlog.set_logName(_name+".log");
-        // 初始化AI - 构造
-        string tempURL=_setting[f(OpenAI_URL)];
-        if(!_config[f(Attach_Global)]){
-            _log.tlog("附加模式为false");
-            _openaiKey.set_path(_basePath/"openai.key");
-            init_key();
-            tempURL=_config[f(OpenAI_URL)];
-            if(tempURL.empty()){
-                _log.tlog("OpenAI API地址为空,使用默认地址",loglib::WARNING);
-                tempURL="https://api.openai.com/v1";
-                _config[f(OpenAI_URL)]=tempURL;
-                _config.save();
-            }
-        }
-        _AI.setBaseUrl(tempURL);
-        _AI.setToken(_openaiKey.get());
-        // 初始化系统提示词
+        timer.lap("配置与源码");
+        // AI在第一次对话时初始化
+        _aiReady=false;
+        // 初始化历史记录
         init_system();
+        timer.lap("历史记录");
         // 读入错误样例集合
-        _WAdatas.set_path(_basePath/"WAdatas.json");
-        if(!_WAdatas.exist()){
-            _log.tlog("错误样例集合不存在,正在重建",loglib::WARNING);
-            _WAdatas.get()=json::array();
-            _WAdatas.save();
-        }
+        open_WAdatas();
+        timer.lap("错误样例");
+        _log.tlog("载入耗时:"+timer.cost,loglib::DEBUG);
         _log.tlog("载入"+_name+"成功");
         _testlog.tlog("重新载入成功");
         return true;
     }
     // 测试工具生成编译
-    bool AutoTest::make(ConfigSign name,json &session){
+    bool AutoTest::make(ConfigSign name,json &session,const string &variant,const string &focus){
         string nameStr;
         switch(name){
         case Generators:
@@ -662,7 +792,23 @@ namespace acm{
         }
         string prompt;
         _testlog.tlog("正在生成"+nameStr);
-        prompt=_prompt[f(name)];
+        prompt=get_prompt(f(name));
+        // 批量模式需要生成器支持多组输出
+        if(name==Generators&&_config.get().value(f(Gen_Batch),1)!=1){
+            prompt+="\n数据生成器还需要支持批量模式: 当以参数 batch L K 运行时，"
+                "对 L 到 L+K-1 的每个编号 i，先调用 rnd.setSeed(i)，再调用 startTest(i)，然后输出第 i 组数据；"
+                "以单个编号参数运行时行为不变。";
+        }
+        // 规模调度需要生成器接受规模参数
+        if(name==Generators&&_config.get().value(f(Size_Max),0LL)>0){
+            prompt+="\n数据生成器还需要支持规模参数: 运行参数的最后多出一个正整数 n 时(如 "+f(name)+" 5 n 或 batch L K n)，"
+                "生成的数据规模(如元素个数)应为 n 左右且不超过题目限制；没有该参数时行为不变。";
+        }
+        // 生成器组合中的其他生成器
+        if(name==Generators&&!variant.empty()){
+            nameStr+=variant;
+            prompt+="\n这是与之前的数据生成器并行使用的另一个数据生成器，运行参数与输出格式相同，但只侧重生成: "+focus;
+        }
         // 处理请求
         AI(prompt,session);
         _testlog.tlog(nameStr+"生成成功");
@@ -677,7 +823,7 @@ namespace acm{
         }
         string code=result["code"];
         // 写入文件
-        string fileName=f(name);
+        string fileName=variant.empty()?f(name):variant;
         wfile(_basePath/string(fileName+".cpp"),code);
         // 编译文件
         _testlog.tlog("正在编译"+nameStr);
@@ -686,12 +832,42 @@ namespace acm{
         process::Process proc("/bin/g++",args);
         proc.start();
         process::Status status=proc.wait();
-        return status==process::STOP;
+        if(status!=process::STOP){
+            return false;
+        }
+        if(name==Generators||name==Validators){
+            reset_sampling();
+        }
+        if(name==Generators){
+            _genHash.clear();
+        }
+        // 额外编译共享库版本的数据生成器和验证器，失败时仍使用可执行文件
+        bool shared=(name==Generators&&variant.empty()&&_config.get().value(f(Gen_Shared),false))||
+            (name==Validators&&_config.get().value(f(Validator_Service),false));
+        if(shared){
+            // 重新编译后需要重新载入
+            if(name==Generators){
+                _genLib.close();
+                _genLoaded=false;
+            }
+            else{
+                _valLib.close();
+                _valLoaded=false;
+            }
+            process::Args libArgs("g++");
+            libArgs.add(fileName+".cpp").add("-O2").add("-shared").add("-fPIC").add("-fno-gnu-unique").add("-o").add(fileName+".so");
+            process::Process libProc("/bin/g++",libArgs);
+            libProc.start();
+            if(libProc.wait()!=process::STOP){
+                _testlog.tlog("共享库版本的"+nameStr+"编译失败,将使用可执行文件",loglib::WARNING);
+            }
+        }
+        return true;
     }
     // 生成测试工具
     AutoTest &AutoTest::gen(){
         // 初始化提示词
-        json &session=_history.get();
+        json &session=get_session();
         session.push_back({
             { "role","user" },
             { "content","完整题面为: "+_problem },
@@ -699,22 +875,31 @@ namespace acm{
             { "content","AC代码为: "+_ACCode }
             });
         // 保存
-        _history.save();
+        save_history();
         bool temp;
         // 数据生成器
         temp=make(Generators,session);
         if(temp){
-            _history.save();
+            save_history();
             _testlog.tlog("数据生成器生成成功");
         }
         else{
             _testlog.tlog("数据生成器生成失败",loglib::ERROR);
             return *this;
         }
+        // 生成器组合中的其他生成器，失败时不使用该生成器
+        for(const auto &[variant,focus]:_config.get().value(f(Gen_Portfolio),json::object()).items()){
+            if(make(Generators,session,variant,focus.get<string>())){
+                save_history();
+            }
+            else{
+                _testlog.tlog("数据生成器"+variant+"生成失败",loglib::WARNING);
+            }
+        }
         // 数据校验器
         temp=make(Validators,session);
         if(temp){
-            _history.save();
+            save_history();
             _testlog.tlog("数据校验器生成成功");
         }
         else{
@@ -724,7 +909,7 @@ namespace acm{
         // 数据检查器
         temp=make(Checkers,session);
         if(temp){
-            _history.save();
+            save_history();
             _testlog.tlog("数据检查器生成成功");
         }
         else{
@@ -763,33 +948,65 @@ namespace acm{
         process::Process proc;
         // 返回值
         Exit res;
-        string dataName=_config[f(NowData)].get<string>();
+        string dataName=_config.get().value(f(NowData),string());
         switch(name){
         case Generators:{
             nameStr="数据生成器";
             runfile/=f(name);
+            if((!_seedsReady&&!init_seeds())||(!_rampReady&&!init_ramp())||(!_portfolioReady&&!init_portfolio())){
+                res.status=process::ERROR;
+                return res;
+            }
             // 读取计数
             int num=_config[f(DataNum)];
             num++;
             _config[f(DataNum)]=num;
             // 更新文件
             _config[f(NowData)]="data"+std::to_string(num);
+            dataName=_config[f(NowData)].get<string>();
+            lap();
+            // 覆盖引导: 按比例变异覆盖到新边的输入，不消耗种子
+            _genMutant=_cov.is_open()&&!_corpus.empty()&&
+                std::uniform_real_distribution<double>(0,1)(_covRng)<_config.get().value(f(Coverage_Mutate),0.5);
+            if(_genMutant){
+                _config.save();
+                res=gen_mutant(dataName,dataDirs[0]/(dataName+".in"));
+                break;
+            }
+            // 分配种子，数据重新生成时也使用新的种子
+            long long left=_seeds.remaining();
+            long long seed=_seeds.next();
+            _config[f(Seed_Pos)]=_seeds.position();
             _config.save();
-            // 设置路径
-            args.add(f(name)).add(std::to_string(num)).add(">").add(dataDirs[0]/(dataName+".in"));
-            proc.load(runfile,args);
-            _testlog.tlog("正在运行"+nameStr);
-            proc.start();
-            // 等待运行结束
-            res.status=proc.wait();;
-            res.exit_code=proc.get_exit_code();
+            long long size=_ramp.enabled()?_ramp.size():0;
+            if(size>0){
+                // 一批不能跨出当前规模档
+                left=std::min<long long>(left,_ramp.remaining());
+            }
+            // 选择生成器
+            _genArm=_bandit.enabled()?_bandit.select():0;
+            string gen=_arms[_genArm];
+            if(_bandit.enabled()){
+                _armOf[dataName]=_genArm;
+            }
+            record_seed(dataName,gen,seed,size);
+            // 批量模式只用于generators
+            if(use_batch()&&_genArm==0){
+                res=run_batch(seed,left,size,dataDirs[0]/(dataName+".in"));
+                break;
+            }
+            res=gen_seed(gen,seed,size,dataDirs[0]/(dataName+".in"));
             break;
         }
         case Validators:{
             nameStr="数据验证器";
             runfile/=f(name);
-            args.add(f(name)).add("<").add(dataDirs[1]/(dataName+".in"));
+            args.add(f(name));
+            if(run_service(dataDirs[0]/(dataName+".in"),res)){
+                break;
+            }
             proc.load(runfile,args);
+            proc.set_redirect(process::PIPE_IN,dataDirs[0]/(dataName+".in"));
             _testlog.tlog("正在运行"+nameStr);
             proc.start();
             // 等待运行结束
@@ -820,12 +1037,26 @@ namespace acm{
             res.status=proc.wait();
             res.exit_code=proc.get_exit_code();
             break;
-        case AC_Code:
+        case AC_Code:{
             // 运行AC代码
             nameStr="AC代码";
             runfile=_ACfile;
-            args.add(_ACfile).add("<").add(dataDirs[0]/(dataName+".in")).add(">").add(dataDirs[1]/(dataName+".out"));
+            args.add(_ACfile);
+            // 同样的输入只运行一次AC代码
+            uint64_t key=0;
+            if(_acCache.enabled()){
+                MappedFile data(dataDirs[0]/(dataName+".in"));
+                key=hash64(data.view(),_acHash);
+                if(_acCache.get(key,dataDirs[2]/(dataName+".out"))){
+                    _testlog.tlog("AC代码的输出命中缓存");
+                    res.status=process::STOP;
+                    res.exit_code=0;
+                    break;
+                }
+            }
             proc.load(runfile,args);
+            proc.set_redirect(process::PIPE_IN,dataDirs[0]/(dataName+".in"));
+            proc.set_redirect(process::PIPE_OUT,dataDirs[2]/(dataName+".out"));
             _testlog.tlog("正在运行"+nameStr);
             proc.set_timeout(_config[f(TimeLimit)]);
             proc.set_memout(_config[f(MemLimit)]);
@@ -833,13 +1064,26 @@ namespace acm{
             // 等待运行结束
             res.status=proc.wait();
             res.exit_code=proc.get_exit_code();
+            // 只缓存正常结束的输出
+            if(_acCache.enabled()&&verdict(res.status,res.exit_code)==Waiting){
+                _acCache.put(key,dataDirs[2]/(dataName+".out"));
+            }
             break;
+        }
         case Test_Code:
             // 运行测试代码
             nameStr="测试代码";
             runfile=_testfile;
-            args.add(_testfile).add("<").add(dataDirs[0]/(dataName+".in")).add(">").add(dataDirs[1]/(dataName+".out"));
+            args.add(_testfile);
+            // 覆盖引导时运行插桩的版本
+            if(_cov.is_open()){
+                runfile=_basePath/"coverage"/"test";
+                _cov.reset();
+                proc.set_env("ACM_COV_FILE",_cov.file().string());
+            }
             proc.load(runfile,args);
+            proc.set_redirect(process::PIPE_IN,dataDirs[0]/(dataName+".in"));
+            proc.set_redirect(process::PIPE_OUT,dataDirs[1]/(dataName+".out"));
             _testlog.tlog("正在运行"+nameStr);
             proc.set_timeout(_config[f(TimeLimit)]);
             proc.set_memout(_config[f(MemLimit)]);
@@ -847,6 +1091,10 @@ namespace acm{
             // 等待运行结束
             res.status=proc.wait();
             res.exit_code=proc.get_exit_code();
+            _lastTestExit=res.exit_code;
+            if(_cov.is_open()){
+                keep_coverage(dataName);
+            }
             break;
         default:
             _log.tlog("未知运行文件: "+f(name),loglib::ERROR);
@@ -854,165 +1102,1803 @@ namespace acm{
         }
         return res;
     }
-    // 开始自动对拍
-    bool AutoTest::start(){
-        // 检测是否已经编译和生成
-        if(fs::exists(f(Generators))&&fs::exists(f(Validators))&&fs::exists(f(Checkers))){
-            _log.tlog("测试文件已经编译,开始自动对拍");
+    // 以共享库运行数据生成器，省去每组数据的exec和动态链接
+    bool AutoTest::run_shared(const process::Args &args,const fs::path &output,const fs::path &workdir,Exit &res){
+        if(!_config.get().value(f(Gen_Shared),false)){
+            return false;
         }
-        else{
-            _log.tlog("测试文件不存在,请先编译",loglib::ERROR);
+        if(!load_shared(Generators,_genLib,_genLoaded)){
             return false;
         }
-        // 开始运行
-        // 循环验证数据直到找到不一致的数据
-        int error_nums=0;
-        while(true){
-            int num=_config[f(DataNum)];
-            _testlog.tlog("正在运行第"+std::to_string(num)+"个测试点");
-            // 生成数据并检查数据是否符合要求
-            Exit res=run(Generators);
-            if(res.status==process::STOP){
-                _testlog.tlog("数据生成器运行成功");
-            }
-            else{
-                _testlog.tlog("数据生成器运行失败",loglib::ERROR);
-                return false;
-            }
-            // 运行数据验证器
-            res=run(Validators);
-            if(res.status==process::STOP){
-                _testlog.tlog("数据验证成功");
-            }
-            else if(res.status==process::ERROR){
-                _testlog.tlog("本次数据生成不符合要求，正在重新生成",loglib::WARNING);
-                // 重置计数
-                auto &temp=_config[f(DataNum)].get_ref<json::number_integer_t&>();
-                temp-=1;
-                _config.save();
-                // 重新生成本次数据
-                continue;
+        _testlog.tlog("正在运行数据生成器(共享库)");
+        res.status=_genLib.run(args,output,workdir);
+        res.exit_code=_genLib.get_exit_code();
+        return true;
+    }
+    // 由常驻验证器验证数据，省去每组数据的进程启动
+    bool AutoTest::run_service(const fs::path &input,Exit &res){
+        if(!_config.get().value(f(Validator_Service),false)){
+            return false;
+        }
+        if(!load_shared(Validators,_valLib,_valLoaded)){
+            return false;
+        }
+        _testlog.tlog("正在运行数据验证器(常驻)");
+        MappedFile data(input);
+        res.status=_valLib.serve(process::Args(f(Validators)),data.view());
+        res.exit_code=_valLib.get_exit_code();
+        return true;
+    }
+    // 载入共享库版本的测试工具
+    bool AutoTest::load_shared(ConfigSign name,process::SharedLib &lib,bool &loaded){
+        // 首次运行时载入，载入失败后不再尝试
+        if(!loaded){
+            loaded=true;
+            fs::path file=_basePath/(f(name)+".so");
+            try{
+                lib.open(file);
+                _testlog.tlog("已载入共享库: "+file.string());
             }
-            else{
-                _testlog.tlog("数据验证器运行失败",loglib::ERROR);
-                return false;
+            catch(const std::exception &e){
+                _testlog.tlog(string(e.what())+",将使用可执行文件",loglib::WARNING);
             }
-            // 运行Test代码获得对应输出
-            res=run(Test_Code);
-            if(res.status==process::STOP){
-                _testlog.tlog("测试代码运行成功");
-                JudgeCode temp=judge(res.status,res.exit_code);
-                _config[f(JudgeStatus)]=f(temp);
-                _config.save();
+        }
+        return lib.is_open();
+    }
+    // 以种子运行数据生成器
+    AutoTest::Exit AutoTest::gen_seed(const string &gen,long long seed,long long size,const fs::path &target){
+        Exit res;
+        process::Args args;
+        args.add(gen).add(std::to_string(seed));
+        if(size>0){
+            args.add(std::to_string(size));
+        }
+        if(gen==f(Generators)&&run_shared(args,target,fs::path(),res)){
+            return res;
+        }
+        process::Process proc(_basePath/gen,args);
+        proc.set_redirect(process::PIPE_OUT,target);
+        _testlog.tlog("正在运行数据生成器");
+        proc.start();
+        // 等待运行结束
+        res.status=proc.wait();
+        res.exit_code=proc.get_exit_code();
+        return res;
+    }
+    // 读取配置初始化种子调度，未记录位置时从数据编号继续，与按编号作为种子保持一致
+    bool AutoTest::init_seeds(){
+        try{
+            _seeds=SeedScheduler(
+                _config.get().value(f(Seed_Base),1LL),
+                _config.get().value(f(Worker_Id),0),
+                _config.get().value(f(Worker_Count),1),
+                _config.get().value(f(Seed_Chunk),1024LL),
+                _config.get().value(f(Seed_Pos),_config.get().value(f(DataNum),0LL)));
+        }
+        catch(const std::exception &e){
+            _testlog.tlog(e.what(),loglib::ERROR);
+            return false;
+        }
+        _seedsReady=true;
+        return true;
+    }
+    bool AutoTest::init_ramp(){
+        long long max=_config.get().value(f(Size_Max),0LL);
+        _ramp=SizeRamp();
+        if(max>0){
+            try{
+                _ramp=SizeRamp(
+                    _config.get().value(f(Size_Min),1LL),max,
+                    _config.get().value(f(Size_Buckets),8),
+                    _config.get().value(f(Size_Tests),100));
             }
-            else{
-                _testlog.tlog("测试代码运行失败",loglib::ERROR);
+            catch(const std::exception &e){
+                _testlog.tlog(e.what(),loglib::ERROR);
                 return false;
             }
-            // 运行AC代码
-            res=run(AC_Code);
-            if(res.status==process::STOP){
-                _testlog.tlog("AC代码运行成功");
-                JudgeCode temp=judge(res.status,res.exit_code);
-                if(temp!=Waiting){
-                    _testlog.tlog("AC代码出现问题, 状态: "+f(temp),loglib::ERROR);
-                    return false;
-                }
+        }
+        _rampReady=true;
+        return true;
+    }
+    bool AutoTest::init_coverage(){
+        _cov.close();
+        _corpus.clear();
+        _covRng.seed(std::random_device()());
+        _mutants=_generatedFinds=_mutantFinds=0;
+        fs::path dir=_basePath/"coverage";
+        fs::create_directories(dir);
+        wfile(dir/"runtime.cpp",CoverageMap::runtime());
+        // 运行时本身不插桩
+        _testlog.tlog("正在编译插桩的测试代码");
+        process::Args rtArgs("g++");
+        rtArgs.add((dir/"runtime.cpp").string()).add("-O2").add("-c").add("-o").add((dir/"runtime.o").string());
+        process::Process rtProc("/bin/g++",rtArgs);
+        rtProc.start();
+        if(rtProc.wait()!=process::STOP){
+            _testlog.tlog("覆盖运行时编译失败,不使用覆盖引导",loglib::WARNING);
+            return false;
+        }
+        process::Args args("g++");
+        args.add("-x").add("c++").add(_testfile.string()).add("-x").add("none").add((dir/"runtime.o").string())
+            .add("-O2").add("-fsanitize-coverage=trace-pc").add("-o").add((dir/"test").string());
+        process::Process proc("/bin/g++",args);
+        proc.start();
+        if(proc.wait()!=process::STOP){
+            _testlog.tlog("测试代码插桩编译失败,不使用覆盖引导",loglib::WARNING);
+            return false;
+        }
+        try{
+            _cov.open(dir/"map");
+        }
+        catch(const std::exception &e){
+            _testlog.tlog(string(e.what())+",不使用覆盖引导",loglib::WARNING);
+            return false;
+        }
+        return true;
+    }
+    void AutoTest::keep_coverage(const string &dataName){
+        size_t found=_cov.merge();
+        if(found==0){
+            return;
+        }
+        (_genMutant?_mutantFinds:_generatedFinds)++;
+        _testlog.tlog(dataName+"覆盖到"+std::to_string(found)+"处新的边,共"+std::to_string(_cov.edges())+"条边");
+        string input=rfile(_basePath/"inData"/(dataName+".in"));
+        archive(dataName,"coverage",false);
+        size_t limit=_config.get().value(f(Coverage_Corpus),(size_t)1024);
+        if(_corpus.size()<limit){
+            _corpus.emplace_back(input,found);
+        }
+        else if(limit>0){
+            // 语料已满时随机替换
+            _corpus[std::uniform_int_distribution<size_t>(0,_corpus.size()-1)(_covRng)]={ input,found };
+        }
+    }
+    AutoTest::Exit AutoTest::gen_mutant(const string &dataName,const fs::path &target){
+        std::vector<double> weights;
+        for(const auto &entry:_corpus){
+            weights.push_back((double)entry.second);
+        }
+        size_t parent=std::discrete_distribution<size_t>(weights.begin(),weights.end())(_covRng);
+        _testlog.tlog("正在变异语料中的输入");
+        wfile(target,mutate(_corpus[parent].first,_covRng));
+        _mutants++;
+        // 变异的数据不属于任何生成器，也无法按种子重新生成
+        _armOf.erase(dataName);
+        json record={
+            { "data",dataName },
+            { "mutated",true }
+        };
+        std::ofstream file(_basePath/"seeds.jsonl",std::ios::app);
+        file<<record.dump()<<"\n";
+        return Exit{ process::STOP,0 };
+    }
+    // generators之外，gen_portfolio中可执行文件存在的生成器加入组合
+    bool AutoTest::init_portfolio(){
+        _arms={ f(Generators) };
+        json portfolio=_config.get().value(f(Gen_Portfolio),json::object());
+        for(const auto &item:portfolio.items()){
+            if(fs::exists(_basePath/item.key())){
+                _arms.push_back(item.key());
             }
             else{
-                _testlog.tlog("AC代码运行失败",loglib::ERROR);
-                return false;
+                _testlog.tlog("数据生成器"+item.key()+"不存在,不加入生成器组合",loglib::WARNING);
             }
-            // 如果已经判题
-            if(_config[f(JudgeStatus)]!=f(Waiting)){
-                error_nums+=1;
-                _testlog.tlog("第"+std::to_string(num)+"个测试点,状态: "+string(_config[f(JudgeStatus)]));
-                // 把当前样例加入错误集合
-                add_WAdatas();
-                return true;
+        }
+        json stats=_config.get().value(f(Gen_Stats),json::object());
+        std::vector<Bandit::Arm> arms(_arms.size());
+        for(size_t i=0;i<_arms.size();i++){
+            if(stats.contains(_arms[i])){
+                const json &arm=stats[_arms[i]];
+                arms[i].runs=arm.value("runs",0LL);
+                arms[i].bugs=arm.value("bugs",0LL);
+                arms[i].time=arm.value("time",0.0);
             }
-            // 运行数据检查器
-            res=run(Checkers);
-            if(res.status==process::STOP){
-                _config[f(JudgeStatus)]=f(Accept);
-                _testlog.tlog(string(_config[f(NowData)])+": "+f(Accept));
-                return true;
+        }
+        _bandit=Bandit(arms);
+        _genArm=0;
+        _portfolioReady=true;
+        if(_bandit.enabled()&&_config.get().value(f(Gen_Batch),1)!=1){
+            _testlog.tlog("生成器组合中各生成器共用种子序列,批量生成的种子无法连续取用,将不使用批量模式",loglib::WARNING);
+        }
+        return true;
+    }
+    void AutoTest::save_portfolio(){
+        if(!_bandit.enabled()){
+            return;
+        }
+        json stats=_config.get().value(f(Gen_Stats),json::object());
+        for(size_t i=0;i<_arms.size();i++){
+            const Bandit::Arm &arm=_bandit.arm(i);
+            stats[_arms[i]]={
+                { "runs",arm.runs },
+                { "bugs",arm.bugs },
+                { "time",arm.time }
+            };
+        }
+        _config[f(Gen_Stats)]=stats;
+        _config.save();
+    }
+    // 两次生成之间的时间(验证、运行、比较)都计入上一组
+    void AutoTest::lap(){
+        auto now=std::chrono::steady_clock::now();
+        // 变异生成的数据不属于任何规模档和生成器
+        if(_genStarted&&!_genMutant){
+            std::chrono::duration<double> cost=now-_genLast;
+            if(_ramp.enabled()){
+                _ramp.record(cost.count());
             }
-            else if(res.status==process::ERROR){
-                // 获取非零状态码
-                if(WIFEXITED(res.exit_code)){
-                    int actual_code=WEXITSTATUS(res.exit_code);
-                    if(actual_code==1){
-                        _config[f(JudgeStatus)]=f(WrongAnswer);
-                    }
-                    else if(actual_code==2){
-                        _config[f(JudgeStatus)]=f(PresentationError);
-                    }
-                    else{
-                        _config[f(JudgeStatus)]=f(RuntimeError);
-                    }
-                    _testlog.tlog("第"+std::to_string(num)+"个测试点,状态: "+string(_config[f(JudgeStatus)]));
-                    // 当前样例添加到错误集合
-                    add_WAdatas();
-                    return true;
-                }
-                else
-                    return false;
+            if(_bandit.enabled()){
+                _bandit.record(_genArm,cost.count());
             }
-            else{
-                _testlog.tlog("数据检查器运行失败",loglib::ERROR);
-                return false;
+        }
+        _genLast=now;
+        _genStarted=true;
+    }
+    const string &AutoTest::gen_hash(const string &gen){
+        string &hash=_genHash[gen];
+        if(hash.empty()){
+            fs::path file=_basePath/(gen+".cpp");
+            if(!fs::exists(file)){
+                file=_basePath/gen;
             }
+            MappedFile data(file);
+            hash=hex64(hash64(data.view()));
         }
+        return hash;
     }
-    // 添加错误集合
-    void AutoTest::add_WAdatas(){
-        string dataName=_config[f(NowData)];
-        string in=rfile(_basePath/"inData"/(dataName+".in"));
-        string out=rfile(_basePath/"acData"/(dataName+".out"));
-        // 添加到错误样例集合
-        json temp={
-            { "in",in },
-            { "out",out }
+    // 每行一条记录，只追加
+    void AutoTest::record_seed(const string &dataName,const string &gen,long long seed,long long size){
+        json record={
+            { "data",dataName },
+            { "gen",gen_hash(gen) },
+            { "seed",seed },
+            { "batch",use_batch()&&gen==f(Generators) }
         };
-        _WAdatas.get().push_back(temp);
-        _WAdatas.save();
+        if(gen!=f(Generators)){
+            record["generator"]=gen;
+        }
+        if(size>0){
+            record["size"]=size;
+        }
+        std::ofstream file(_basePath/"seeds.jsonl",std::ios::app);
+        file<<record.dump()<<"\n";
     }
-    void AutoTest::add_to_cph(){
+    // 按种子记录重新生成数据
+    bool AutoTest::regenerate(const string &dataName){
+        std::ifstream file(_basePath/"seeds.jsonl");
+        json found;
+        string line;
+        // 同一数据可能因验证不通过重新生成过，以最后一条为准
+        while(std::getline(file,line)){
+            if(line.empty()){
+                continue;
+            }
+            json record=json::parse(line,nullptr,false);
+            if(!record.is_discarded()&&record.value("data",string())==dataName){
+                found=record;
+            }
+        }
+        if(found.is_null()){
+            _testlog.tlog("没有"+dataName+"的种子记录",loglib::ERROR);
+            return false;
+        }
+        string gen=found.value("generator",f(Generators));
+        if(found["gen"]!=gen_hash(gen)){
+            _testlog.tlog("数据生成器已经变化,重新生成的"+dataName+"可能与原数据不同",loglib::WARNING);
+        }
+        if(found.value("mutated",false)){
+            _testlog.tlog(dataName+"由变异生成,没有种子",loglib::ERROR);
+            return false;
+        }
+        long long seed=found["seed"];
+        long long size=found.value("size",0LL);
+        fs::path target=_basePath/"inData"/(dataName+".in");
+        fs::create_directories(target.parent_path());
+        Exit res;
+        // 批量模式下的种子由startTest设置，需要按批量协议重新生成
+        if(found.value("batch",false)){
+            _genBatch.clear();
+            res=run_batch(seed,1,size,target);
+        }
+        else{
+            res=gen_seed(gen,seed,size,target);
+        }
+        if(res.status!=process::STOP){
+            _testlog.tlog("重新生成"+dataName+"失败",loglib::ERROR);
+            return false;
+        }
+        _testlog.tlog("已按种子"+std::to_string(seed)+"重新生成"+dataName);
+        return true;
+    }
+    void AutoTest::passed(const string &dataName){
+        _armOf.erase(dataName);
+        if(_config.get().value(f(Keep_Passed),true)){
+            return;
+        }
+        fs::remove(_basePath/"inData"/(dataName+".in"));
+        fs::remove(_basePath/"outData"/(dataName+".out"));
+        fs::remove(_basePath/"acData"/(dataName+".out"));
+    }
+    // 启用生成器组合时其他生成器会取走批量中间的种子，每次都要重新生成一批
+    bool AutoTest::use_batch(){
+        return _config.get().value(f(Gen_Batch),1)!=1&&!_bandit.enabled();
+    }
+    // 批量运行数据生成器，一次启动通过testlib的startTest生成多组数据
+    AutoTest::Exit AutoTest::run_batch(long long seed,long long left,long long size,const fs::path &target){
+        Exit res{ process::STOP,0 };
+        fs::path batchDir=_basePath/"inData"/"batch";
+        if(!_genBatch.ready(seed,size)){
+            // 清理上一批未使用的数据
+            _genBatch.clear();
+            fs::remove_all(batchDir);
+            fs::create_directories(batchDir);
+            // 一批不能跨出当前种子块，gen_batch为0时自动调节
+            int fixed=_config.get().value(f(Gen_Batch),1);
+            int count=_genBatch.count(fixed,left);
+            // 生成器在批量目录中运行，startTest(i)输出到文件i
+            process::Args args;
+            args.add(f(Generators)).add("batch").add(std::to_string(seed)).add(std::to_string(count));
+            if(size>0){
+                args.add(std::to_string(size));
+            }
+            _testlog.tlog("正在批量运行数据生成器: "+std::to_string(seed)+"~"+std::to_string(seed+count-1));
+            auto begin=std::chrono::steady_clock::now();
+            if(!run_shared(args,fs::path(),batchDir,res)){
+                process::Process proc(fs::absolute(_basePath/f(Generators)),args);
+                proc.set_workdir(batchDir);
+                proc.start();
+                res.status=proc.wait();
+                res.exit_code=proc.get_exit_code();
+            }
+            std::chrono::duration<double> cost=std::chrono::steady_clock::now()-begin;
+            if(res.status!=process::STOP){
+                return res;
+            }
+            if(fixed==0&&_genBatch.tune(count,cost.count())){
+                _testlog.tlog(
+                    "生成器启动开销: "+std::to_string(_genBatch.overhead()*1000)+"ms,"+
+                    " 单组耗时: "+std::to_string(_genBatch.per()*1000)+"ms,"+
+                    " 批量大小调节为: "+std::to_string(_genBatch.count(0,1024)));
+            }
+            _genBatch.fill(seed,count,size);
+        }
+        _genBatch.pop();
+        fs::path file=batchDir/std::to_string(seed);
+        if(!fs::exists(file)){
+            _testlog.tlog("批量生成缺少数据: "+file.string(),loglib::ERROR);
+            res.status=process::ERROR;
+            return res;
+        }
+        fs::rename(file,target);
+        return res;
+    }
+    // 流式运行测试代码与AC代码，边运行边比较，出现差异立即终止
+    bool AutoTest::run_stream(JudgeCode &code){
+        string dataName=_config[f(NowData)];
+        MappedFile inFile(_basePath/"inData"/(dataName+".in"));
+        std::string_view input=inFile.view();
+        StreamCompare cmp;
+        if(compare_mode()=="float"){
+            cmp=StreamCompare(_config.get().value(f(Abs_Eps),1e-6),_config.get().value(f(Rel_Eps),1e-6));
+        }
+        // 0 测试代码 1 AC代码
+        fs::path files[2]={ _testfile,_ACfile };
+        process::Process procs[2];
+        // 测试代码的输出边读取边写入文件，不在内存中累积
+        fs::create_directories(_basePath/"outData");
+        std::ofstream output(_basePath/"outData"/(dataName+".out"),std::ios::binary|std::ios::trunc);
+        // 一侧领先另一侧超过该字节数时暂停读取，比较缓冲区的大小因此有上限
+        const size_t maxLag=1<<20;
+        size_t written[2]={ 0,0 };
+        bool outOpen[2]={ true,true },errOpen[2]={ true,true };
+        _testlog.tlog("正在流式运行测试代码与AC代码");
+        for(int side=0;side<2;side++){
+            process::Args args;
+            args.add(files[side]);
+            procs[side].load(files[side],args);
+            procs[side].set_timeout(_config.get().value(f(TimeLimit),1000));
+            procs[side].set_memout(_config.get().value(f(MemLimit),256));
+            procs[side].start();
+            if(input.empty()){
+                procs[side].close(process::PIPE_IN);
+            }
+            else{
+                process::System::set_non_blocking(procs[side].get_handle(process::PIPE_IN),true);
+            }
+        }
+        char buffer[65536];
+        while(!cmp.done()){
+            std::vector<pollfd> fds;
+            // 每个描述符对应的进程与管道
+            std::vector<std::pair<int,process::PipeType>> owners;
+            for(int side=0;side<2;side++){
+                if(written[side]<input.size()){
+                    fds.push_back({ procs[side].get_handle(process::PIPE_IN),POLLOUT,0 });
+                    owners.push_back({ side,process::PIPE_IN });
+                }
+                // 领先的一侧暂停读取，写满管道后阻塞，等另一侧追上；两侧都积压时(超长token)不暂停
+                bool ahead=cmp.pending(side)>=maxLag&&cmp.pending(side^1)<maxLag&&outOpen[side^1];
+                if(outOpen[side]&&!ahead){
+                    fds.push_back({ procs[side].get_handle(process::PIPE_OUT),POLLIN,0 });
+                    owners.push_back({ side,process::PIPE_OUT });
+                }
+                if(errOpen[side]){
+                    fds.push_back({ procs[side].get_handle(process::PIPE_ERR),POLLIN,0 });
+                    owners.push_back({ side,process::PIPE_ERR });
+                }
+            }
+            if(fds.empty()){
+                break;
+            }
+            // 超时由进程计时器终止子进程，管道随之关闭
+            if(poll(fds.data(),fds.size(),-1)<0){
+                if(errno==EINTR){
+                    continue;
+                }
+                throw std::runtime_error("流式比较poll失败: "+string(strerror(errno)));
+            }
+            for(size_t idx=0;idx<fds.size()&&!cmp.done();idx++){
+                if(fds[idx].revents==0){
+                    continue;
+                }
+                auto [side,type]=owners[idx];
+                if(type==process::PIPE_IN){
+                    ssize_t n=::write(fds[idx].fd,input.data()+written[side],std::min(input.size()-written[side],sizeof(buffer)));
+                    if(n>0){
+                        written[side]+=n;
+                    }
+                    else if(n<0&&errno!=EAGAIN&&errno!=EINTR){
+                        // 子进程不再读取输入
+                        written[side]=input.size();
+                    }
+                    if(written[side]==input.size()){
+                        procs[side].close(process::PIPE_IN);
+                    }
+                    continue;
+                }
+                ssize_t n=::read(fds[idx].fd,buffer,sizeof(buffer));
+                if(n<0&&(errno==EAGAIN||errno==EINTR)){
+                    continue;
+                }
+                if(type==process::PIPE_ERR){
+                    errOpen[side]=n>0;
+                }
+                else if(n>0){
+                    if(side==0){
+                        output.write(buffer,n);
+                    }
+                    cmp.feed(side,buffer,n);
+                }
+                else{
+                    // 输出结束后立即回收，停止该进程的计时器
+                    outOpen[side]=false;
+                    procs[side].wait();
+                    cmp.close(side);
+                }
+            }
+        }
+        // 仍在运行的进程直接终止
+        for(int side=0;side<2;side++){
+            if(outOpen[side]){
+                procs[side].kill(SIGKILL);
+            }
+        }
+        JudgeCode acCode=verdict(procs[1].get_status(),procs[1].get_exit_code());
+        if(acCode!=Waiting){
+            _testlog.tlog("AC代码出现问题, 状态: "+f(acCode),loglib::ERROR);
+            return false;
+        }
+        code=verdict(procs[0].get_status(),procs[0].get_exit_code());
+        _lastTestExit=procs[0].get_exit_code();
+        if(code==Waiting){
+            code=cmp.result().same?Accept:WrongAnswer;
+        }
+        if(code==Accept){
+            return true;
+        }
+        _lastCompare=cmp.result();
+        if(!cmp.result().same){
+            _testlog.tlog(
+                dataName+": 第"+std::to_string(cmp.result().token+1)+"个token不同,"+
+                "输出偏移: "+std::to_string(cmp.result().offsetA)+
+                " 答案偏移: "+std::to_string(cmp.result().offsetB)+", 已提前终止");
+        }
+        // 测试输出已写入文件，AC代码完整重跑一次得到完整答案
+        output.close();
+        Exit res=run(AC_Code);
+        if(res.status!=process::STOP){
+            _testlog.tlog("AC代码运行失败",loglib::ERROR);
+            return false;
+        }
+        return true;
+    }
+    // 运行当前数据的测试代码与AC代码并进行进程内比较，AC代码异常返回false
+    bool AutoTest::judge_current(JudgeCode &code){
+        if(_config.get().value(f(Stream_Mode),false)){
+            return run_stream(code);
+        }
+        Exit res=run(Test_Code);
+        code=verdict(res.status,res.exit_code);
+        res=run(AC_Code);
+        if(res.status!=process::STOP){
+            _testlog.tlog("AC代码运行失败",loglib::ERROR);
+            return false;
+        }
+        if(code==Waiting){
+            code=compare();
+        }
+        return true;
+    }
+    // 把多组以测试组数T开头的数据拼成一组运行，失败时定位到具体的子测试并单独确认
+    bool AutoTest::run_pack(const std::vector<string> &names,JudgeCode &code){
+        if(names.size()==1){
+            _config[f(NowData)]=names[0];
+            return judge_current(code);
+        }
+        fs::path inDir=_basePath/"inData";
+        // 每组数据包含的子测试数
+        std::vector<long long> cases;
+        long long total=0;
+        string body;
+        for(const auto &name:names){
+            MappedFile in(inDir/(name+".in"));
+            std::string_view data=in.view();
+            size_t pos=0;
+            while(pos<data.size()&&isspace((unsigned char)data[pos])){
+                pos++;
+            }
+            long long count=0;
+            auto [ptr,ec]=std::from_chars(data.data()+pos,data.data()+data.size(),count);
+            if(ec!=std::errc()||count<=0){
+                _testlog.tlog(name+": 数据不以测试组数开头,无法打包",loglib::ERROR);
+                return false;
+            }
+            // 去掉组数所在行的换行，保持拼接后的行结构
+            pos=ptr-data.data();
+            while(pos<data.size()&&(data[pos]==' '||data[pos]=='\t'||data[pos]=='\r')){
+                pos++;
+            }
+            if(pos<data.size()&&data[pos]=='\n'){
+                pos++;
+            }
+            body.append(data.substr(pos));
+            if(!body.empty()&&body.back()!='\n'){
+                body+='\n';
+            }
+            cases.push_back(count);
+            total+=count;
+        }
+        wfile(inDir/"pack.in",std::to_string(total)+"\n"+body);
+        _config[f(NowData)]="pack";
+        _testlog.tlog("打包运行"+std::to_string(names.size())+"组数据,共"+std::to_string(total)+"个子测试");
+        // 打包后的数据也需要满足题目约束，不满足时拆成两半
+        Exit res=run(Validators);
+        if(res.status==process::ERROR){
+            _testlog.tlog("打包数据不符合要求,拆分后重试",loglib::WARNING);
+            size_t half=names.size()/2;
+            std::vector<string> left(names.begin(),names.begin()+half);
+            std::vector<string> right(names.begin()+half,names.end());
+            if(!run_pack(left,code)){
+                return false;
+            }
+            return code==Accept?run_pack(right,code):true;
+        }
+        else if(res.status!=process::STOP){
+            _testlog.tlog("数据验证器运行失败",loglib::ERROR);
+            return false;
+        }
+        if(!judge_current(code)){
+            return false;
+        }
+        if(code==Accept){
+            return true;
+        }
+        // 先单独运行按答案中的行号定位到的那组，通过时再逐个运行其余各组
+        long long line=-1;
+        if(code==WrongAnswer){
+            MappedFile ac(_basePath/"acData"/"pack.out");
+            std::string_view data=ac.view().substr(0,_lastCompare.offsetB);
+            line=std::count(data.begin(),data.end(),'\n');
+        }
+        for(size_t i:pack_order(cases,line,_config.get().value(f(Pack_Lines),1))){
+            _config[f(NowData)]=names[i];
+            JudgeCode sub;
+            if(!judge_current(sub)){
+                return false;
+            }
+            if(sub!=Accept){
+                _testlog.tlog("打包数据的失败定位到: "+names[i]);
+                code=sub;
+                return true;
+            }
+        }
+        // 单独运行都通过，保留打包数据作为错误样例
+        _testlog.tlog("失败只在打包运行时出现,可能是多组数据之间状态未清空",loglib::WARNING);
+        _config[f(NowData)]="pack";
+        return true;
+    }
+    // 开始自动对拍
+    bool AutoTest::start(){
+        bool res=run_session();
+        report_session();
+        _config.flush();
+        return res;
+    }
+    // 在hunt/<线程编号>/中生成、验证并运行测试代码，以测试代码的CPU时间为代价爬山
+    bool AutoTest::hunt(){
+        if(!fs::exists(_basePath/f(Generators))||!fs::exists(_basePath/f(Validators))){
+            _log.tlog("测试文件不存在,请先编译",loglib::ERROR);
+            return false;
+        }
+        // 线程中只读取这里取出的配置
+        int timeLimit=_config[f(TimeLimit)];
+        int memLimit=_config[f(MemLimit)];
+        int rounds=_config.get().value(f(Hunt_Rounds),50);
+        int jobs=std::max(1,_config.get().value(f(Hunt_Jobs),(int)std::max(1u,std::thread::hardware_concurrency())));
+        long long sizeMax=_config.get().value(f(Size_Max),0LL);
+        long long sizeMin=sizeMax>0?_config.get().value(f(Size_Min),1LL):0;
+        // 超过时限数倍后不再区分快慢
+        int cap=timeLimit>0?timeLimit*4:0;
+        fs::path baseDir=_basePath/"hunt";
+        for(int k=0;k<jobs;k++){
+            fs::create_directories(baseDir/std::to_string(k));
+        }
+        auto measure=[&](long long seed,long long size,int worker){
+            fs::path dir=baseDir/std::to_string(worker);
+            fs::path in=dir/"data.in",out=dir/"test.out";
+            process::Args args(f(Generators));
+            args.add(std::to_string(seed));
+            if(size>0){
+                args.add(std::to_string(size));
+            }
+            // 共享库和常驻验证器不能在多个线程中使用
+            process::Process gen((_basePath/f(Generators)).string(),args);
+            gen.set_redirect(process::PIPE_OUT,in.string());
+            gen.start();
+            if(gen.wait()!=process::STOP){
+                return -1.0;
+            }
+            process::Process val((_basePath/f(Validators)).string(),process::Args(f(Validators)));
+            val.set_redirect(process::PIPE_IN,in.string());
+            val.start();
+            if(val.wait()!=process::STOP){
+                return -1.0;
+            }
+            process::Process test(_testfile,process::Args(_testfile));
+            test.set_redirect(process::PIPE_IN,in.string());
+            test.set_redirect(process::PIPE_OUT,out.string());
+            if(cap>0){
+                test.set_timeout(cap);
+            }
+            test.set_memout(memLimit);
+            test.start();
+            // 墙钟超时被终止时CPU时间不完整，按上限计
+            if(test.wait()==process::TIMEOUT){
+                return std::max(test.get_cpu_time(),cap/1000.0);
+            }
+            return test.get_cpu_time();
+        };
+        SlowSearch search(measure,jobs,sizeMin,sizeMax);
+        _testlog.tlog("开始超时搜索: "+std::to_string(rounds)+"轮,每轮"+std::to_string(jobs)+"个候选");
+        for(int i=0;i<rounds;i++){
+            double last=search.best().cost;
+            const auto &best=search.step();
+            if(best.cost>last){
+                _testlog.tlog(
+                    "第"+std::to_string(i+1)+"轮: 种子"+std::to_string(best.seed)+
+                    (best.size>0?" 规模"+std::to_string(best.size):string())+
+                    " 测试代码"+std::to_string(best.cost)+"秒");
+            }
+            if(cap>0&&best.cost*1000>=cap){
+                _testlog.tlog("测试代码已达到时限的4倍,停止搜索");
+                break;
+            }
+        }
+        const auto &best=search.best();
+        if(best.cost<0){
+            _testlog.tlog("没有生成合法的输入",loglib::ERROR);
+            return false;
+        }
+        // 重新生成最慢的输入，并以AC代码的CPU时间作为参照
+        fs::path in=_basePath/"inData"/"hunt.in",ac=_basePath/"acData"/"hunt.out";
+        fs::create_directories(in.parent_path());
+        fs::create_directories(ac.parent_path());
+        measure(best.seed,best.size,0);
+        fs::copy_file(baseDir/"0"/"data.in",in,fs::copy_options::overwrite_existing);
+        process::Process acProc(_ACfile,process::Args(_ACfile));
+        acProc.set_redirect(process::PIPE_IN,in.string());
+        acProc.set_redirect(process::PIPE_OUT,ac.string());
+        if(cap>0){
+            acProc.set_timeout(cap);
+        }
+        acProc.set_memout(memLimit);
+        acProc.start();
+        process::Status acStatus=acProc.wait();
+        double acTime=acProc.get_cpu_time();
+        string ratio=acTime>0?std::to_string(best.cost/acTime):string("∞");
+        _testlog.tlog(
+            "最慢输入: 种子"+std::to_string(best.seed)+(best.size>0?" 规模"+std::to_string(best.size):string())+
+            ", 测试代码"+std::to_string(best.cost)+"秒, AC代码"+std::to_string(acTime)+"秒, 比值"+ratio+
+            ", 共评估"+std::to_string(search.evaluations())+"个候选, 已保存到"+in.string());
+        if(acStatus!=process::STOP){
+            _testlog.tlog("AC代码在最慢输入上运行失败",loglib::WARNING);
+            return false;
+        }
+        if(timeLimit<=0||best.cost*1000<=timeLimit){
+            _testlog.tlog("没有找到超过时限的输入");
+            return false;
+        }
+        _testlog.tlog("找到超过时限的输入",loglib::WARNING);
+        _WAdatas.append({
+            { "in",rfile(in) },
+            { "out",rfile(ac) },
+            { "failed_at",(long long)std::time(nullptr) }
+        });
+        return true;
+    }
+    // 自动对拍主循环
+    bool AutoTest::run_session(){
+        // 检测是否已经编译和生成
+        if(fs::exists(f(Generators))&&fs::exists(f(Validators))&&fs::exists(f(Checkers))){
+            _log.tlog("测试文件已经编译,开始自动对拍");
+        }
+        else{
+            _log.tlog("测试文件不存在,请先编译",loglib::ERROR);
+            return false;
+        }
+        if(!check_compare_mode()){
+            return false;
+        }
+        // 流式比较只能配合进程内比较使用
+        bool stream=_config.get().value(f(Stream_Mode),false);
+        if(stream&&compare_mode()=="checker"){
+            _log.tlog("流式比较需要进程内比较模式,将使用检查器",loglib::WARNING);
+            stream=false;
+        }
+        // 覆盖引导，流式比较不经过插桩的测试代码
+        _cov.close();
+        if(_config.get().value(f(Coverage),false)){
+            if(stream){
+                _log.tlog("覆盖引导不支持流式比较,将不使用覆盖引导",loglib::WARNING);
+            }
+            else{
+                init_coverage();
+            }
+        }
+        init_ac_cache();
+        if(init_corpus_store()){
+            _testlog.tlog("语料库: "+std::to_string(_store.size())+"份数据");
+        }
+        // 候选解法只在逐组运行时对拍
+        init_candidates();
+        if(!_candidates.empty()&&(stream||_config.get().value(f(Pack_Size),1)>1)){
+            _log.tlog("候选解法只支持逐组运行,将不运行候选解法",loglib::WARNING);
+            _candidates.clear();
+        }
+        // 打包运行同样只能配合进程内比较使用
+        int packSize=_config.get().value(f(Pack_Size),1);
+        if(packSize>1&&compare_mode()=="checker"){
+            _log.tlog("打包运行需要进程内比较模式,将逐组运行",loglib::WARNING);
+            packSize=1;
+        }
+        // 等待打包的数据
+        std::vector<string> pending;
+        // 连续重复的组数
+        int duplicates=0;
+        const int maxDuplicates=1000;
+        // 继续对拍时的组数和时间限制
+        bool keepGoing=_config.get().value(f(Keep_Going),false);
+        long long maxTests=_config.get().value(f(Max_Tests),0LL);
+        double maxTime=_config.get().value(f(Max_Time),0.0);
+        _buckets=FailureBuckets(_config.get().value(f(Bucket_Samples),(size_t)3));
+        int startNum=_config[f(DataNum)];
+        auto begin=std::chrono::steady_clock::now();
+        // 开始运行
+        // 循环验证数据直到找到不一致的数据
+        int error_nums=0;
+        // 运行攒下的一批数据，返回-1 运行出错 1 记录了失败且对拍应结束 0 继续
+        auto runPending=[&]()->int{
+            JudgeCode temp;
+            std::vector<string> names;
+            names.swap(pending);
+            if(!run_pack(names,temp)){
+                return -1;
+            }
+            _config[f(JudgeStatus)]=f(temp);
+            if(temp==Accept){
+                _testlog.tlog("打包的"+std::to_string(names.size())+"组数据: "+f(Accept));
+                for(const auto &name:names){
+                    passed(name);
+                }
+                return 0;
+            }
+            // 只保留定位到的失败数据，其余各组(单独运行通过的，或拆分后未运行的)与逐组运行通过时一样清理
+            string failed=_config[f(NowData)];
+            for(const auto &name:names){
+                if(name!=failed){
+                    passed(name);
+                }
+            }
+            _testlog.tlog(failed+",状态: "+string(_config[f(JudgeStatus)]));
+            if(!confirm_valid()){
+                return 0;
+            }
+            return record_failure()?1:0;
+        };
+        while(true){
+            int num=_config[f(DataNum)];
+            if(keepGoing){
+                std::chrono::duration<double> elapsed=std::chrono::steady_clock::now()-begin;
+                if((maxTests>0&&num-startNum>=maxTests)||(maxTime>0&&elapsed.count()>=maxTime)){
+                    // 已生成并验证但未攒满一批的数据也要运行
+                    if(!pending.empty()){
+                        int res=runPending();
+                        if(res!=0){
+                            return res>0;
+                        }
+                    }
+                    _testlog.tlog("已运行"+std::to_string(num-startNum)+"组,继续对拍结束");
+                    return _buckets.total()>0;
+                }
+            }
+            _testlog.tlog("正在运行第"+std::to_string(num)+"个测试点");
+            // 生成数据并检查数据是否符合要求
+            Exit res=run(Generators);
+            if(res.status==process::STOP){
+                _testlog.tlog("数据生成器运行成功");
+            }
+            else{
+                _testlog.tlog("数据生成器运行失败",loglib::ERROR);
+                return false;
+            }
+            // 跳过已经测试过的输入，复用数据编号
+            if(is_duplicate()){
+                auto &temp=_config[f(DataNum)].get_ref<json::number_integer_t&>();
+                temp-=1;
+                _config.save();
+                // 生成器只能产生少量不同的输入时停止
+                if(++duplicates>=maxDuplicates){
+                    _testlog.tlog("连续"+std::to_string(duplicates)+"组数据重复,生成器难以产生新的输入",loglib::WARNING);
+                    return false;
+                }
+                continue;
+            }
+            duplicates=0;
+            // 连续通过验证后按抽样跳过
+            if(pending.empty()){
+                _valSkipped.clear();
+            }
+            if(_genMutant){
+                // 变异的输入总是验证，不计入生成器的抽样统计，编号仍视为连续
+                _valLastNum=num+1;
+                res=run(Validators);
+            }
+            else if(!sample_validate(num+1)){
+                _valSkipped.insert(_config[f(NowData)]);
+                _testlog.tlog("按抽样跳过数据验证");
+                res.status=process::STOP;
+            }
+            else{
+                res=validate();
+            }
+            if(res.status==process::STOP){
+                _testlog.tlog("数据验证成功");
+            }
+            else if(res.status==process::ERROR){
+                _testlog.tlog("本次数据生成不符合要求，正在重新生成",loglib::WARNING);
+                // 重置计数
+                auto &temp=_config[f(DataNum)].get_ref<json::number_integer_t&>();
+                temp-=1;
+                _config.save();
+                // 重新生成本次数据
+                continue;
+            }
+            else{
+                _testlog.tlog("数据验证器运行失败",loglib::ERROR);
+                return false;
+            }
+            // 打包模式: 攒够一批再统一运行
+            if(packSize>1){
+                pending.push_back(_config[f(NowData)]);
+                if((int)pending.size()<packSize){
+                    continue;
+                }
+                int res=runPending();
+                if(res!=0){
+                    return res>0;
+                }
+                continue;
+            }
+            // 流式运行并比较
+            if(stream){
+                JudgeCode temp;
+                if(!run_stream(temp)){
+                    return false;
+                }
+                _config[f(JudgeStatus)]=f(temp);
+                if(temp==Accept){
+                    _testlog.tlog(string(_config[f(NowData)])+": "+f(Accept));
+                    passed(_config[f(NowData)]);
+                    continue;
+                }
+                _testlog.tlog("第"+std::to_string(num)+"个测试点,状态: "+string(_config[f(JudgeStatus)]));
+                if(!confirm_valid()){
+                    continue;
+                }
+                if(record_failure()){
+                    return true;
+                }
+                continue;
+            }
+            // 候选解法与测试代码同时运行
+            launch_candidates(_config[f(NowData)]);
+            // 运行Test代码获得对应输出
+            res=run(Test_Code);
+            // 超时、超内存和崩溃同样是测试代码的失败，运行AC代码后按失败记录
+            JudgeCode testCode=verdict(res.status,res.exit_code);
+            if(testCode==Waiting){
+                _testlog.tlog("测试代码运行成功");
+            }
+            else{
+                _testlog.tlog("测试代码异常结束: "+f(testCode),loglib::WARNING);
+            }
+            _config[f(JudgeStatus)]=f(testCode);
+            _config.save();
+            // 运行AC代码
+            res=run(AC_Code);
+            if(res.status==process::STOP){
+                _testlog.tlog("AC代码运行成功");
+                JudgeCode temp=judge(res.status,res.exit_code);
+                if(temp!=Waiting){
+                    _testlog.tlog("AC代码出现问题, 状态: "+f(temp),loglib::ERROR);
+                    join_candidates();
+                    return false;
+                }
+            }
+            else{
+                _testlog.tlog("AC代码运行失败",loglib::ERROR);
+                join_candidates();
+                return false;
+            }
+            judge_candidates(_config[f(NowData)]);
+            // 如果已经判题
+            if(_config[f(JudgeStatus)]!=f(Waiting)){
+                error_nums+=1;
+                _testlog.tlog("第"+std::to_string(num)+"个测试点,状态: "+string(_config[f(JudgeStatus)]));
+                if(!confirm_valid()){
+                    continue;
+                }
+                // 把当前样例加入错误集合
+                if(record_failure()){
+                    return true;
+                }
+                continue;
+            }
+            // 进程内比较(token/float)，不启动检查器
+            if(compare_mode()!="checker"){
+                JudgeCode temp=compare();
+                _config[f(JudgeStatus)]=f(temp);
+                if(temp==Accept){
+                    _testlog.tlog(string(_config[f(NowData)])+": "+f(Accept));
+                    passed(_config[f(NowData)]);
+                    continue;
+                }
+                _testlog.tlog("第"+std::to_string(num)+"个测试点,状态: "+string(_config[f(JudgeStatus)]));
+                if(!confirm_valid()){
+                    continue;
+                }
+                if(record_failure()){
+                    return true;
+                }
+                continue;
+            }
+            // 运行数据检查器
+            res=run(Checkers);
+            if(res.status==process::STOP){
+                _config[f(JudgeStatus)]=f(Accept);
+                _testlog.tlog(string(_config[f(NowData)])+": "+f(Accept));
+                passed(_config[f(NowData)]);
+                continue;
+            }
+            else if(res.status==process::ERROR){
+                // 获取非零状态码
+                if(WIFEXITED(res.exit_code)){
+                    int actual_code=WEXITSTATUS(res.exit_code);
+                    if(actual_code==1){
+                        _config[f(JudgeStatus)]=f(WrongAnswer);
+                    }
+                    else if(actual_code==2){
+                        _config[f(JudgeStatus)]=f(PresentationError);
+                    }
+                    else{
+                        _config[f(JudgeStatus)]=f(RuntimeError);
+                    }
+                    _testlog.tlog("第"+std::to_string(num)+"个测试点,状态: "+string(_config[f(JudgeStatus)]));
+                    if(!confirm_valid()){
+                        continue;
+                    }
+                    // 当前样例添加到错误集合
+                    if(record_failure()){
+                        return true;
+                    }
+                    continue;
+                }
+                else
+                    return false;
+            }
+            else{
+                _testlog.tlog("数据检查器运行失败",loglib::ERROR);
+                return false;
+            }
+        }
+    }
+    // 按输入内容的哈希去重
+    bool AutoTest::is_duplicate(){
+        if(!_config.get().value(f(Dedup),true)){
+            return false;
+        }
+        if(!_seenReady){
+            _seen=SeenSet(_config.get().value(f(Dedup_Limit),(size_t)1<<20));
+            _seenReady=true;
+        }
+        string dataName=_config[f(NowData)];
+        fs::path file=_basePath/"inData"/(dataName+".in");
+        uint64_t hash;
+        {
+            MappedFile data(file);
+            hash=hash64(data.view());
+        }
+        _dedupStats.generated++;
+        if(_seen.insert(hash)){
+            return false;
+        }
+        _dedupStats.duplicates++;
+        _testlog.tlog(dataName+"与已测试的输入重复,跳过");
+        fs::remove(file);
+        return true;
+    }
+    // 错误样例按最近失败的时间排序，cph中的测试排在最后；每个线程在replay/<线程编号>/中运行测试代码并与保存的答案比较
+    bool AutoTest::replay(bool all){
+        struct Case{
+            // cph中的测试直接保存输入和答案，错误样例运行时再读取
+            string in,out;
+            // 日志中的来源
+            string source;
+            // 失败时间，cph中的测试为-1
+            long long failedAt=-1;
+            // 在错误样例集合中的位置，cph中的测试为-1
+            long long index=-1;
+        };
+        std::vector<Case> cases;
+        std::unordered_set<uint64_t> seen;
+        // 候选解法的失败记录不是测试代码的错误样例
+        size_t candidateRecords=0;
+        // 逐条读取错误样例，只保留排序和去重所需的信息
+        _WAdatas.for_each([&](size_t i,const json &item){
+            if(!item.contains("in")||!item.contains("out")){
+                return;
+            }
+            if(item.contains("candidate")){
+                candidateRecords++;
+                return;
+            }
+            if(seen.insert(hash64(item["in"].get_ref<const string &>())).second){
+                cases.push_back({ string(),string(),"错误样例#"+std::to_string(i),item.value("failed_at",0LL),(long long)i });
+            }
+        });
+        // 没有失败时间的旧样例按加入的先后，后加入的优先
+        std::stable_sort(cases.begin(),cases.end(),[](const Case &a,const Case &b){
+            return a.failedAt!=b.failedAt?a.failedAt>b.failedAt:a.index>b.index;
+        });
+        if(candidateRecords>0){
+            _testlog.tlog("跳过"+std::to_string(candidateRecords)+"条候选解法的失败记录");
+        }
+        // add_to_cph加入的测试与错误样例重复，按输入去重
+        fs::path cph=cph_file();
+        if(!cph.empty()){
+            json data=json::parse(rfile(cph),nullptr,false);
+            if(!data.is_discarded()&&data.contains("tests")){
+                for(const auto &test:data["tests"]){
+                    Case c{ test.value("input",string()),test.value("output",string()),"cph#"+test.value("id",json()).dump() };
+                    if(seen.insert(hash64(c.in)).second){
+                        cases.push_back(std::move(c));
+                    }
+                }
+            }
+        }
+        if(cases.empty()){
+            _testlog.tlog("没有可以重放的样例");
+            return true;
+        }
+        if(!check_compare_mode()){
+            return false;
+        }
+        // 线程中只读取这里取出的配置
+        int timeLimit=_config[f(TimeLimit)];
+        int memLimit=_config[f(MemLimit)];
+        string mode=compare_mode();
+        double absEps=_config.get().value(f(Abs_Eps),1e-6);
+        double relEps=_config.get().value(f(Rel_Eps),1e-6);
+        int jobs=std::max(1,_config.get().value(f(Replay_Jobs),(int)std::max(1u,std::thread::hardware_concurrency())));
+        jobs=std::min<int>(jobs,cases.size());
+        fs::path baseDir=_basePath/"replay";
+        for(int k=0;k<jobs;k++){
+            fs::create_directories(baseDir/std::to_string(k));
+        }
+        _testlog.tlog("正在重放"+std::to_string(cases.size())+"组样例,"+std::to_string(jobs)+"个线程");
+        auto begin=std::chrono::steady_clock::now();
+        // 各样例的判题结果，ran标记是否已经运行
+        std::vector<JudgeCode> results(cases.size(),Waiting);
+        std::vector<char> ran(cases.size(),0);
+        std::atomic<size_t> next{ 0 };
+        std::atomic<bool> stop{ false };
+        auto work=[&](int worker){
+            fs::path dir=baseDir/std::to_string(worker);
+            fs::path in=dir/"data.in",out=dir/"test.out",ac=dir/"ac.out";
+            while(!stop){
+                size_t i=next++;
+                if(i>=cases.size()){
+                    return;
+                }
+                if(cases[i].index>=0){
+                    json item=_WAdatas.at(cases[i].index);
+                    wfile(in,item["in"]);
+                    wfile(ac,item["out"]);
+                }
+                else{
+                    wfile(in,cases[i].in);
+                    wfile(ac,cases[i].out);
+                }
+                process::Process test(_testfile,process::Args(_testfile));
+                test.set_redirect(process::PIPE_IN,in.string());
+                test.set_redirect(process::PIPE_OUT,out.string());
+                if(timeLimit>0){
+                    test.set_timeout(timeLimit);
+                }
+                test.set_memout(memLimit);
+                test.start();
+                process::Status status=test.wait();
+                JudgeCode code=verdict(status,test.get_exit_code());
+                if(code==Waiting){
+                    code=check_output(in,out,ac,mode,absEps,relEps);
+                }
+                results[i]=code;
+                ran[i]=1;
+                if(code!=Accept&&!all){
+                    stop=true;
+                }
+            }
+        };
+        std::vector<std::thread> threads;
+        for(int k=1;k<jobs;k++){
+            threads.emplace_back(work,k);
+        }
+        work(0);
+        for(auto &t:threads){
+            t.join();
+        }
+        std::chrono::duration<double> elapsed=std::chrono::steady_clock::now()-begin;
+        size_t passed=0,failed=0,skipped=0;
+        for(size_t i=0;i<cases.size();i++){
+            if(!ran[i]){
+                skipped++;
+                continue;
+            }
+            if(results[i]==Accept){
+                passed++;
+                continue;
+            }
+            failed++;
+            _testlog.tlog(cases[i].source+": "+(results[i]==Waiting?string("检查器异常"):f(results[i])),loglib::WARNING);
+            // 再次失败的样例下次优先重放
+            if(cases[i].index>=0){
+                _WAdatas.update(cases[i].index,{ { "failed_at",(long long)std::time(nullptr) } });
+            }
+        }
+        _testlog.tlog(
+            "重放: "+std::to_string(cases.size())+"组, 通过"+std::to_string(passed)+"组, 失败"+std::to_string(failed)+"组"+
+            (skipped>0?", 未运行"+std::to_string(skipped)+"组":string())+", 耗时"+std::to_string(elapsed.count())+"秒");
+        return failed==0;
+    }
+    void AutoTest::open_WAdatas(){
+        fs::path file=_basePath/"WAdatas.jsonl";
+        fs::path legacy=_basePath/"WAdatas.json";
+        bool fresh=!fs::exists(file);
+        _WAdatas.open(file);
+        if(!fresh||!fs::exists(legacy)){
+            return;
+        }
+        json old=json::parse(rfile(legacy),nullptr,false);
+        if(old.is_array()){
+            for(const auto &item:old){
+                _WAdatas.append(item);
+            }
+            _log.tlog("已把WAdatas.json中的"+std::to_string(old.size())+"个错误样例转为WAdatas.jsonl");
+        }
+        fs::rename(legacy,_basePath/"WAdatas.json.bak");
+    }
+    // AC代码变化后缓存的键随之变化，旧的输出按最近使用时间被淘汰
+    void AutoTest::init_ac_cache(){
+        long long limit=_config.get().value(f(AC_Cache),0LL);
+        if(limit<=0){
+            _acCache.open(fs::path(),0);
+            return;
+        }
+        MappedFile code(_ACfile);
+        _acHash=hash64(code.view());
+        _acCache.open(_basePath/"cache"/"ac",(uintmax_t)limit<<20);
+        _testlog.tlog("AC代码输出缓存: "+std::to_string(_acCache.size())+"组");
+    }
+    // 语料库在全局配置目录下，相同的数据在各题目和各次对拍之间只保存一份
+    bool AutoTest::init_corpus_store(){
+        if(!_config.get().value(f(Corpus_Store),false)){
+            return false;
+        }
+        if(!_store.is_open()){
+            _store.open(_path/"corpus");
+        }
+        if(!_storeIndex.is_open()||_storeIndex.path()!=_basePath/"corpus.jsonl"){
+            _storeIndex.open(_basePath/"corpus.jsonl");
+        }
+        return true;
+    }
+    void AutoTest::archive(const string &dataName,const string &kind,bool drop){
+        if(!_store.is_open()){
+            return;
+        }
+        json record={
+            { "data",dataName },
+            { "kind",kind },
+            { "at",(long long)std::time(nullptr) }
+        };
+        if(kind=="failure"){
+            record["status"]=_config[f(JudgeStatus)];
+        }
+        const std::pair<const char *,fs::path> files[]={
+            { "in",_basePath/"inData"/(dataName+".in") },
+            { "out",_basePath/"outData"/(dataName+".out") },
+            { "ac",_basePath/"acData"/(dataName+".out") }
+        };
+        try{
+            for(const auto &[key,file]:files){
+                if(fs::exists(file)){
+                    record[key]=_store.put_file(file);
+                }
+            }
+            _storeIndex.append(record);
+        }
+        catch(const std::exception &e){
+            // 存入失败时保留原文件
+            _testlog.tlog(dataName+"存入语料库失败: "+e.what(),loglib::WARNING);
+            return;
+        }
+        if(drop){
+            for(const auto &[key,file]:files){
+                fs::remove(file);
+            }
+        }
+    }
+    bool AutoTest::restore(const string &dataName){
+        try{
+            if(!init_corpus_store()){
+                _testlog.tlog("没有开启语料库",loglib::ERROR);
+                return false;
+            }
+        }
+        catch(const std::exception &e){
+            _testlog.tlog(string("打开语料库失败: ")+e.what(),loglib::ERROR);
+            return false;
+        }
+        // 同一数据可能存入过多次，以最后一条为准
+        json found;
+        _storeIndex.for_each([&](size_t,const json &record){
+            if(record.value("data",string())==dataName){
+                found=record;
+            }
+        });
+        if(found.is_null()){
+            _testlog.tlog("语料库中没有"+dataName,loglib::ERROR);
+            return false;
+        }
+        const std::pair<const char *,fs::path> files[]={
+            { "in",_basePath/"inData"/(dataName+".in") },
+            { "out",_basePath/"outData"/(dataName+".out") },
+            { "ac",_basePath/"acData"/(dataName+".out") }
+        };
+        for(const auto &[key,file]:files){
+            if(!found.contains(key)){
+                continue;
+            }
+            string data;
+            if(!_store.get(found[key],data)){
+                _testlog.tlog("语料库中"+dataName+"的"+key+"已丢失或损坏",loglib::ERROR);
+                return false;
+            }
+            fs::create_directories(file.parent_path());
+            wfile(file,data);
+        }
+        _testlog.tlog("已从语料库恢复"+dataName);
+        return true;
+    }
+    void AutoTest::init_candidates(){
+        _candidates.clear();
+        json list=_config.get().value(f(Candidates),json::array());
+        for(const auto &item:list){
+            string name=item.get<string>();
+            if(!fs::exists(_basePath/"candidates"/(name+".cpp"))){
+                _testlog.tlog("候选解法"+name+"不存在,将不运行",loglib::WARNING);
+                continue;
+            }
+            fs::create_directories(_basePath/"candidates"/name);
+            _candidates.emplace_back();
+            _candidates.back().name=name;
+        }
+        if(!_candidates.empty()){
+            _testlog.tlog("同时对拍"+std::to_string(_candidates.size())+"个候选解法");
+        }
+    }
+    // 每个候选一个线程，与测试代码和AC代码同时运行，输出到candidates/<名字>/
+    void AutoTest::launch_candidates(const string &dataName){
+        int timeLimit=_config[f(TimeLimit)];
+        int memLimit=_config[f(MemLimit)];
+        fs::path in=_basePath/"inData"/(dataName+".in");
+        for(auto &c:_candidates){
+            fs::path file=_basePath/"candidates"/(c.name+".cpp");
+            fs::path out=_basePath/"candidates"/c.name/(dataName+".out");
+            c.worker=std::thread([&c,file,in,out,timeLimit,memLimit](){
+                process::Process proc(file.string(),process::Args(file.string()));
+                proc.set_redirect(process::PIPE_IN,in.string());
+                proc.set_redirect(process::PIPE_OUT,out.string());
+                if(timeLimit>0){
+                    proc.set_timeout(timeLimit);
+                }
+                proc.set_memout(memLimit);
+                proc.start();
+                c.exit.status=proc.wait();
+                c.exit.exit_code=proc.get_exit_code();
+            });
+        }
+    }
+    void AutoTest::join_candidates(){
+        for(auto &c:_candidates){
+            if(c.worker.joinable()){
+                c.worker.join();
+            }
+        }
+    }
+    void AutoTest::judge_candidates(const string &dataName){
+        join_candidates();
+        if(_candidates.empty()){
+            return;
+        }
+        string mode=compare_mode();
+        double absEps=_config.get().value(f(Abs_Eps),1e-6);
+        double relEps=_config.get().value(f(Rel_Eps),1e-6);
+        size_t samples=_config.get().value(f(Bucket_Samples),(size_t)3);
+        fs::path in=_basePath/"inData"/(dataName+".in");
+        fs::path ac=_basePath/"acData"/(dataName+".out");
+        for(auto &c:_candidates){
+            fs::path dir=_basePath/"candidates"/c.name;
+            fs::path out=dir/(dataName+".out");
+            c.runs++;
+            JudgeCode code=verdict(c.exit.status,c.exit.exit_code);
+            if(code==Waiting){
+                code=check_output(in,out,ac,mode,absEps,relEps);
+            }
+            if(code==Accept){
+                fs::remove(out);
+                continue;
+            }
+            string status=code==Waiting?string("检查器异常"):f(code);
+            c.failures++;
+            c.verdicts[status]++;
+            _testlog.tlog("候选解法"+c.name+"在"+dataName+"上: "+status,loglib::WARNING);
+            if(c.failures>(long long)samples){
+                fs::remove(out);
+                continue;
+            }
+            // 测试代码通过时数据文件可能被删除，输入复制到候选自己的目录
+            fs::copy_file(in,dir/(dataName+".in"),fs::copy_options::overwrite_existing);
+            _WAdatas.append({
+                { "in",rfile(in) },
+                { "out",rfile(ac) },
+                { "candidate",c.name },
+                { "status",status },
+                { "failed_at",(long long)std::time(nullptr) }
+            });
+        }
+    }
+    void AutoTest::report_session(){
+        if(_store.is_open()&&_store.puts()>0){
+            _testlog.tlog(
+                "语料库: 本次存入"+std::to_string(_store.puts())+"个文件, 其中"+std::to_string(_store.shared())+"个已存在,"
+                " 共"+std::to_string(_store.size())+"份("+std::to_string(_store.raw_bytes()>>10)+"KB, 压缩后"+
+                std::to_string(_store.packed_bytes()>>10)+"KB)");
+        }
+        if(_acCache.enabled()&&_acCache.hits()+_acCache.misses()>0){
+            _testlog.tlog(
+                "AC代码输出缓存: 命中"+std::to_string(_acCache.hits())+"次, 未命中"+std::to_string(_acCache.misses())+"次,"
+                " 淘汰"+std::to_string(_acCache.evictions())+"组, 共"+std::to_string(_acCache.size())+"组("+
+                std::to_string(_acCache.bytes()>>10)+"KB)");
+        }
+        for(const auto &c:_candidates){
+            string verdicts;
+            for(const auto &[status,count]:c.verdicts){
+                verdicts+=" "+status+" "+std::to_string(count);
+            }
+            _testlog.tlog(
+                "候选解法"+c.name+": 运行"+std::to_string(c.runs)+"组, 失败"+std::to_string(c.failures)+"次"+
+                (verdicts.empty()?string():","+verdicts));
+        }
+        if(_cov.is_open()){
+            _testlog.tlog(
+                "覆盖: "+std::to_string(_cov.edges())+"条边, 语料"+std::to_string(_corpus.size())+"组,"
+                " 变异"+std::to_string(_mutants)+"组,"
+                " 新覆盖: 生成"+std::to_string(_generatedFinds)+"组 变异"+std::to_string(_mutantFinds)+"组");
+        }
+        if(_buckets.total()>0){
+            _testlog.tlog(
+                "失败: 共"+std::to_string(_buckets.total())+"次,"
+                " "+std::to_string(_buckets.buckets().size())+"个桶"+
+                (_buckets.overflow()>0?", 超过桶数上限"+std::to_string(_buckets.overflow())+"次":""));
+            json summary=json::object();
+            for(const auto &[signature,bucket]:_buckets.buckets()){
+                string names;
+                for(const auto &name:bucket.exemplars){
+                    names+=" "+name;
+                }
+                _testlog.tlog("["+signature+"] "+std::to_string(bucket.count)+"次, 样例:"+names);
+                summary[signature]={
+                    { "count",bucket.count },
+                    { "exemplars",bucket.exemplars }
+                };
+            }
+            wfile(_basePath/"buckets.json",summary.dump(4));
+        }
+        // 最后一组的耗时
+        if(_genStarted){
+            lap();
+            _genStarted=false;
+        }
+        save_portfolio();
+        for(size_t i=0;_bandit.enabled()&&i<_bandit.arms();i++){
+            const Bandit::Arm &arm=_bandit.arm(i);
+            _testlog.tlog(
+                _arms[i]+": 累计"+std::to_string(arm.runs)+"组,"
+                " 错误"+std::to_string(arm.bugs)+"个,"
+                " 耗时"+std::to_string(arm.time)+"s,"
+                " "+std::to_string(arm.yield())+"个/s");
+        }
+        if(_dedupStats.generated>0){
+            _testlog.tlog(
+                "去重: 生成"+std::to_string(_dedupStats.generated)+"组,"
+                " 重复"+std::to_string(_dedupStats.duplicates)+"组,"
+                " 跳过率"+std::to_string(_dedupStats.rate()*100)+"%"+
+                (_seen.is_bloom()?" (布隆过滤器)":""));
+        }
+        for(size_t i=0;i<_ramp.buckets();i++){
+            if(_ramp.count_of(i)==0){
+                continue;
+            }
+            double time=_ramp.time_of(i);
+            _testlog.tlog(
+                "规模"+std::to_string(_ramp.size_of(i))+": "+std::to_string(_ramp.count_of(i))+"组,"
+                " 耗时"+std::to_string(time)+"s,"
+                " "+std::to_string(time>0?_ramp.count_of(i)/time:0)+"组/s");
+        }
+        if(_valStats.skipped>0){
+            _testlog.tlog(
+                "抽样验证: 验证"+std::to_string(_valStats.validated)+"组,"
+                " 跳过"+std::to_string(_valStats.skipped)+"组,"
+                " 估计节省"+std::to_string(_valStats.saved())+"s");
+        }
+    }
+    double AutoTest::DedupStats::rate() const{
+        return generated>0?(double)duplicates/generated:0;
+    }
+    const AutoTest::DedupStats &AutoTest::get_dedup_stats() const{
+        return _dedupStats;
+    }
+    // 前warmup组全部验证，之后抽样比例按warmup/连续组数衰减，最低1/64
+    bool AutoTest::sample_validate(int num){
+        int warmup=_config.get().value(f(Validate_Warmup),0);
+        // 编号不连续说明换了种子范围
+        if(num!=_valLastNum+1){
+            _valStreak=0;
+            _valCredit=0;
+        }
+        _valLastNum=num;
+        if(warmup<=0||_valStreak<warmup){
+            return true;
+        }
+        _valStreak++;
+        _valCredit+=std::max((double)warmup/_valStreak,1.0/64);
+        if(_valCredit>=1){
+            _valCredit-=1;
+            return true;
+        }
+        _valStats.skipped++;
+        if(_valStats.skipped%1000==0){
+            _testlog.tlog(
+                "已抽样跳过"+std::to_string(_valStats.skipped)+"组数据验证,"
+                " 估计节省: "+std::to_string(_valStats.saved())+"s");
+        }
+        return false;
+    }
+    AutoTest::Exit AutoTest::validate(){
+        auto begin=std::chrono::steady_clock::now();
+        Exit res=run(Validators);
+        std::chrono::duration<double> cost=std::chrono::steady_clock::now()-begin;
+        _valStats.validated++;
+        _valStats.time+=cost.count();
+        if(res.status==process::STOP){
+            _valStreak++;
+        }
+        else if(res.status==process::ERROR){
+            _valStats.rejected++;
+            _valStreak=0;
+            _valCredit=0;
+        }
+        return res;
+    }
+    bool AutoTest::confirm_valid(){
+        string dataName=_config[f(NowData)];
+        if(!_valSkipped.erase(dataName)){
+            return true;
+        }
+        _testlog.tlog("失败的数据跳过了验证,正在补充验证");
+        Exit res=validate();
+        if(res.status!=process::ERROR){
+            return true;
+        }
+        _testlog.tlog(dataName+"不符合要求,已丢弃",loglib::WARNING);
+        return false;
+    }
+    void AutoTest::reset_sampling(){
+        _valStreak=0;
+        _valCredit=0;
+        _valSkipped.clear();
+    }
+    double AutoTest::ValidateStats::saved() const{
+        return validated>0?skipped*time/validated:0;
+    }
+    const AutoTest::ValidateStats &AutoTest::get_validate_stats() const{
+        return _valStats;
+    }
+    // 所有读取比较模式的地方使用同一个默认值
+    string AutoTest::compare_mode(){
+        return _config.get().value(f(Compare_Mode),string("checker"));
+    }
+    bool AutoTest::check_compare_mode(){
+        string mode=compare_mode();
+        if(mode!="checker"&&mode!="token"&&mode!="float"){
+            _testlog.tlog("未知的比较模式: "+mode+",应为checker、token或float",loglib::ERROR);
+            return false;
+        }
+        return true;
+    }
+    // 进程内比较测试输出与AC输出
+    JudgeCode AutoTest::compare(){
+        string dataName=_config[f(NowData)];
+        // 直接比较映射的文件内容，不拷贝
+        MappedFile out(_basePath/"outData"/(dataName+".out"));
+        MappedFile ac(_basePath/"acData"/(dataName+".out"));
+        CompareResult res;
+        if(compare_mode()=="float"){
+            double absEps=_config.get().value(f(Abs_Eps),1e-6);
+            double relEps=_config.get().value(f(Rel_Eps),1e-6);
+            res=compare_numbers(out.data(),out.size(),ac.data(),ac.size(),absEps,relEps);
+        }
+        else{
+            res=compare_tokens(out.data(),out.size(),ac.data(),ac.size());
+        }
+        _lastCompare=res;
+        if(res.same){
+            return Accept;
+        }
+        _testlog.tlog(
+            dataName+": 第"+std::to_string(res.token+1)+"个token不同,"+
+            "输出偏移: "+std::to_string(res.offsetA)+
+            " 答案偏移: "+std::to_string(res.offsetB));
+        return WrongAnswer;
+    }
+    JudgeCode AutoTest::check_output(const fs::path &in,const fs::path &out,const fs::path &ac,const string &mode,double absEps,double relEps){
+        if(mode=="checker"){
+            process::Args args(f(Checkers));
+            args.add(in).add(out).add(ac);
+            process::Process checker((_basePath/f(Checkers)).string(),args);
+            checker.start();
+            process::Status res=checker.wait();
+            int exitCode=checker.get_exit_code();
+            if(res==process::STOP){
+                return Accept;
+            }
+            if(res==process::ERROR&&WIFEXITED(exitCode)){
+                int actual=WEXITSTATUS(exitCode);
+                return actual==1?WrongAnswer:actual==2?PresentationError:RuntimeError;
+            }
+            return Waiting;
+        }
+        MappedFile outData(out),acData(ac);
+        CompareResult res=mode=="float"?
+            compare_numbers(outData.data(),outData.size(),acData.data(),acData.size(),absEps,relEps):
+            compare_tokens(outData.data(),outData.size(),acData.data(),acData.size());
+        return res.same?Accept:WrongAnswer;
+    }
+    // 添加错误集合
+    void AutoTest::add_WAdatas(){
+        string dataName=_config[f(NowData)];
+        MappedFile in(_basePath/"inData"/(dataName+".in"));
+        MappedFile out(_basePath/"acData"/(dataName+".out"));
+        // 添加到错误样例集合，记录失败时间供重放排序
+        json temp={
+            { "in",string(in.view()) },
+            { "out",string(out.view()) },
+            { "failed_at",(long long)std::time(nullptr) }
+        };
+        // 最小化的输入与原输入一起保存
+        if(_config.get().value(f(Minimize),false)){
+            string small=minimize_failure(string(in.view()),_config[f(JudgeStatus)]);
+            if(!small.empty()){
+                temp["min_in"]=small;
+                temp["min_out"]=rfile(_basePath/"minimize"/"0"/"ac.out");
+                wfile(_basePath/"inData"/(dataName+".min.in"),small);
+                wfile(_basePath/"acData"/(dataName+".min.out"),temp["min_out"]);
+            }
+        }
+        _WAdatas.append(temp);
+    }
+    // 按行再按token做ddmin，每个候选经过验证器、测试代码、AC代码和比较，状态相同才视为仍然失败
+    string AutoTest::minimize_failure(const string &input,const string &status){
+        // 线程中只读取这里取出的配置
+        int timeLimit=_config[f(TimeLimit)];
+        int memLimit=_config[f(MemLimit)];
+        string mode=compare_mode();
+        double absEps=_config.get().value(f(Abs_Eps),1e-6);
+        double relEps=_config.get().value(f(Rel_Eps),1e-6);
+        int jobs=_config.get().value(f(Minimize_Jobs),(int)std::max(1u,std::thread::hardware_concurrency()));
+        long long limit=_config.get().value(f(Minimize_Limit),2000LL);
+        fs::path baseDir=_basePath/"minimize";
+        for(int k=0;k<std::max(jobs,1);k++){
+            fs::create_directories(baseDir/std::to_string(k));
+        }
+        auto fails=[&](const string &data,int worker){
+            fs::path dir=baseDir/std::to_string(worker);
+            fs::path in=dir/"data.in",out=dir/"test.out",ac=dir/"ac.out";
+            wfile(in,data);
+            // 只尝试合法的输入，常驻验证器不能在多个线程中使用
+            process::Process val((_basePath/f(Validators)).string(),process::Args(f(Validators)));
+            val.set_redirect(process::PIPE_IN,in.string());
+            val.start();
+            if(val.wait()!=process::STOP){
+                return false;
+            }
+            process::Process test(_testfile,process::Args(_testfile));
+            test.set_redirect(process::PIPE_IN,in.string());
+            test.set_redirect(process::PIPE_OUT,out.string());
+            test.set_timeout(timeLimit);
+            test.set_memout(memLimit);
+            test.start();
+            process::Status testStatus=test.wait();
+            JudgeCode code=verdict(testStatus,test.get_exit_code());
+            process::Process acProc(_ACfile,process::Args(_ACfile));
+            acProc.set_redirect(process::PIPE_IN,in.string());
+            acProc.set_redirect(process::PIPE_OUT,ac.string());
+            acProc.set_timeout(timeLimit);
+            acProc.set_memout(memLimit);
+            acProc.start();
+            if(acProc.wait()!=process::STOP){
+                return false;
+            }
+            if(code!=Waiting){
+                return f(code)==status;
+            }
+            code=check_output(in,out,ac,mode,absEps,relEps);
+            return code!=Waiting&&f(code)==status;
+        };
+        _testlog.tlog("正在最小化失败数据("+std::to_string(input.size())+"字节)");
+        Minimizer minimizer(fails,std::max(jobs,1),limit);
+        string small=minimizer.minimize(input,Granularity_Line);
+        small=minimizer.minimize(small,Granularity_Token);
+        if(small.size()>=input.size()){
+            _testlog.tlog("失败数据无法缩小");
+            return string();
+        }
+        // 重新运行一次，留下最小输入的AC输出
+        if(!fails(small,0)){
+            _testlog.tlog("最小化的数据无法复现失败",loglib::WARNING);
+            return string();
+        }
+        _testlog.tlog(
+            "最小化: "+std::to_string(input.size())+"字节 -> "+std::to_string(small.size())+"字节,"
+            " 测试"+std::to_string(minimizer.tests())+"个候选");
+        return small;
+    }
+    // 判题状态加上第一个不同token的位置和两侧的数值类型，或测试代码的信号
+    string AutoTest::failure_signature(){
+        string dataName=_config[f(NowData)];
+        string status=_config[f(JudgeStatus)];
+        JudgeCode code=WrongAnswer;
+        for(JudgeCode temp:{ WrongAnswer,TimeLimitEXceeded,MemoryLimitExceeded,OutputLimitExceeded,FloatingPointError,RuntimeError,PresentationError }){
+            if(f(temp)==status){
+                code=temp;
+            }
+        }
+        fs::path out=_basePath/"outData"/(dataName+".out");
+        fs::path ac=_basePath/"acData"/(dataName+".out");
+        if(!fs::exists(out)||!fs::exists(ac)){
+            return FailureBuckets::signature(code,_lastTestExit,CompareResult(),"","");
+        }
+        MappedFile outData(out),acData(ac);
+        CompareResult cmp;
+        if(compare_mode()=="float"){
+            cmp=compare_numbers(outData.data(),outData.size(),acData.data(),acData.size(),
+                _config.get().value(f(Abs_Eps),1e-6),_config.get().value(f(Rel_Eps),1e-6));
+        }
+        else{
+            cmp=compare_tokens(outData.data(),outData.size(),acData.data(),acData.size());
+        }
+        return FailureBuckets::signature(code,_lastTestExit,cmp,outData.view(),acData.view());
+    }
+    bool AutoTest::record_failure(){
+        string dataName=_config[f(NowData)];
+        // 错误计入生成该数据的生成器
+        auto arm=_armOf.find(dataName);
+        if(arm!=_armOf.end()){
+            _bandit.bug(arm->second);
+            _armOf.erase(arm);
+        }
+        if(!_config.get().value(f(Keep_Going),false)){
+            add_WAdatas();
+            // 对拍在此结束，保留数据文件供查看
+            archive(dataName,"failure",false);
+            return true;
+        }
+        string signature=failure_signature();
+        bool exemplar=_buckets.add(signature,dataName);
+        if(exemplar){
+            _testlog.tlog(dataName+"加入失败桶["+signature+"]");
+            add_WAdatas();
+        }
+        if(_store.is_open()){
+            // 数据压缩存入语料库，可以用restore恢复
+            archive(dataName,"failure",true);
+        }
+        else if(!exemplar){
+            // 同一桶已有足够的样例，不保留数据文件
+            fs::remove(_basePath/"inData"/(dataName+".in"));
+            fs::remove(_basePath/"outData"/(dataName+".out"));
+            fs::remove(_basePath/"acData"/(dataName+".out"));
+        }
+        return false;
+    }
+    fs::path AutoTest::cph_file(){
         // 如果cph路径被赋值才会执行
         if(_cph=="."||_cph.empty()){
-            return;
+            return fs::path();
         }
-        // 在cph文件夹中找到包含name的文件
-        std::vector<fs::path> matched_files;
-
         try{
-            // 遍历CPH文件夹中的所有文件
+            // 在cph文件夹中找到包含name的文件
             for(const auto &entry:fs::directory_iterator(_cph)){
-                // 检查是否是文件且文件名包含指定的字符串
                 if(fs::is_regular_file(entry)&&entry.path().filename().string().find(_name)!=string::npos){
-                    matched_files.push_back(entry.path());
                     _testlog.tlog("找到匹配的CPH文件: "+entry.path().string());
+                    return entry.path();
                 }
             }
-
-            if(matched_files.empty()){
-                _testlog.tlog("CPH: 未找到包含 "+_name+" 的CPH文件",loglib::WARNING);
-                return;
-            }
-
-            // 对找到的文件执行操作...
-            // 例如，可以将 in 和 out 添加到这些文件中
-            for(const auto &file:matched_files){
-                _testlog.tlog("CPH: 处理文件: "+file.string());
-                // 具体的处理逻辑...
-            }
+            _testlog.tlog("CPH: 未找到包含 "+_name+" 的CPH文件",loglib::WARNING);
         }
         catch(const std::exception &e){
             _testlog.tlog("CPH: 查找文件时出错: "+string(e.what()),loglib::ERROR);
         }
+        return fs::path();
+    }
+    void AutoTest::add_to_cph(){
+        fs::path first_file=cph_file();
+        if(first_file.empty()){
+            return;
+        }
         // 以json的方式打开这个文件
-        fs::path first_file=matched_files[0];
         json cph_json;
         // 读取json文件
         try{
@@ -1023,7 +2909,7 @@ namespace acm{
             // 添加测试数据
             if(cph_json.contains("tests")){
                 // 读取错误样例集合最后一个
-                json temp=_WAdatas.get().back();
+                json temp=_WAdatas.back();
 
                 // 创建新的测试用例
                 json new_test={
@@ -1051,13 +2937,12 @@ namespace acm{
     }
     // 析构函数
     AutoTest::~AutoTest(){
+        join_candidates();
         _log.tlog("AutoTest结束运行");
         // 保存历史记录
-        _history.save();
+        save_history();
         // 保存配置文件
         _setting.save();
         _config.save();
-        // 保存错误样例集合
-        _WAdatas.save();
     }
 };
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "Bandit.h"
+#include <stdexcept>
+
+namespace acm{
+    double Bandit::Arm::yield() const{
+        return time>0?bugs/time:0;
+    }
+    Bandit::Bandit(){}
+    Bandit::Bandit(std::vector<Arm> arms,double prior,uint64_t seed):_arms(std::move(arms)),_prior(prior),_rng(seed){
+        if(prior<=0){
+            throw std::runtime_error("Bandit: 先验时间必须为正");
+        }
+    }
+    bool Bandit::enabled() const{
+        return _arms.size()>1;
+    }
+    size_t Bandit::select(){
+        size_t best=0;
+        double bestRate=-1;
+        for(size_t i=0;i<_arms.size();i++){
+            if(_arms[i].runs==0){
+                best=i;
+                break;
+            }
+            // Gamma(形状,尺度)，尺度为速率的倒数
+            std::gamma_distribution<double> posterior(1.0+_arms[i].bugs,1.0/(_prior+_arms[i].time));
+            double rate=posterior(_rng);
+            if(rate>bestRate){
+                bestRate=rate;
+                best=i;
+            }
+        }
+        _arms[best].runs++;
+        return best;
+    }
+    void Bandit::record(size_t arm,double seconds){
+        _arms[arm].time+=seconds;
+    }
+    void Bandit::bug(size_t arm){
+        _arms[arm].bugs++;
+    }
+    size_t Bandit::arms() const{
+        return _arms.size();
+    }
+    const Bandit::Arm &Bandit::arm(size_t i) const{
+        return _arms[i];
+    }
+}
@@ -0,0 +1,431 @@
+#include "Compare.h"
+#include <cstring>
+#include <stdexcept>
+#include <cstdint>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+#if defined(__x86_64__)||defined(__i386__)
+    #define COMPARE_X86 1
+    #include <immintrin.h>
+#endif
+
+namespace acm{
+    namespace{
+        // 空白字符: ' ' 以及 '\t' '\n' '\v' '\f' '\r'
+        inline bool is_space(char c){
+            return c==' '||(unsigned char)(c-'\t')<=4;
+        }
+        // 内核函数表
+        struct Kernel{
+            // 返回前n个字节中第一个不同字节的下标，全部相同返回n
+            size_t (*mismatch)(const char *a,const char *b,size_t n);
+            // 返回前n个字节中第一个非空白字节的下标，全部为空白返回n
+            size_t (*skip_space)(const char *p,size_t n);
+        };
+
+        // 标量实现，按8字节整块比较
+        size_t mismatch_scalar(const char *a,const char *b,size_t n){
+            size_t i=0;
+            for(;i+8<=n;i+=8){
+                uint64_t x,y;
+                std::memcpy(&x,a+i,8);
+                std::memcpy(&y,b+i,8);
+                if(x!=y){
+                    // 小端序下最低的不同字节即第一个不同字节
+#if __BYTE_ORDER__==__ORDER_LITTLE_ENDIAN__
+                    return i+__builtin_ctzll(x^y)/8;
+#else
+                    break;
+#endif
+                }
+            }
+            while(i<n&&a[i]==b[i]){
+                i++;
+            }
+            return i;
+        }
+        size_t skip_space_scalar(const char *p,size_t n){
+            size_t i=0;
+            while(i<n&&is_space(p[i])){
+                i++;
+            }
+            return i;
+        }
+
+#ifdef COMPARE_X86
+        // SSE4.2 实现，空白跳过使用 pcmpestri 字符集匹配
+        __attribute__((target("sse4.2")))
+        size_t mismatch_sse42(const char *a,const char *b,size_t n){
+            size_t i=0;
+            for(;i+16<=n;i+=16){
+                __m128i x=_mm_loadu_si128((const __m128i *)(a+i));
+                __m128i y=_mm_loadu_si128((const __m128i *)(b+i));
+                unsigned mask=(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x,y));
+                if(mask!=0xFFFFu){
+                    return i+__builtin_ctz(~mask);
+                }
+            }
+            return i+mismatch_scalar(a+i,b+i,n-i);
+        }
+        __attribute__((target("sse4.2")))
+        size_t skip_space_sse42(const char *p,size_t n){
+            const __m128i set=_mm_setr_epi8(' ','\t','\n','\v','\f','\r',0,0,0,0,0,0,0,0,0,0);
+            size_t i=0;
+            for(;i+16<=n;i+=16){
+                __m128i x=_mm_loadu_si128((const __m128i *)(p+i));
+                int idx=_mm_cmpestri(set,6,x,16,
+                    _SIDD_UBYTE_OPS|_SIDD_CMP_EQUAL_ANY|_SIDD_NEGATIVE_POLARITY|_SIDD_LEAST_SIGNIFICANT);
+                if(idx<16){
+                    return i+idx;
+                }
+            }
+            return i+skip_space_scalar(p+i,n-i);
+        }
+
+        // AVX2 实现，每次处理32字节
+        __attribute__((target("avx2")))
+        size_t mismatch_avx2(const char *a,const char *b,size_t n){
+            size_t i=0;
+            for(;i+32<=n;i+=32){
+                __m256i x=_mm256_loadu_si256((const __m256i *)(a+i));
+                __m256i y=_mm256_loadu_si256((const __m256i *)(b+i));
+                unsigned mask=(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x,y));
+                if(mask!=0xFFFFFFFFu){
+                    return i+__builtin_ctz(~mask);
+                }
+            }
+            return i+mismatch_scalar(a+i,b+i,n-i);
+        }
+        __attribute__((target("avx2")))
+        size_t skip_space_avx2(const char *p,size_t n){
+            const __m256i space=_mm256_set1_epi8(' ');
+            const __m256i tab=_mm256_set1_epi8('\t');
+            const __m256i range=_mm256_set1_epi8(4);
+            size_t i=0;
+            for(;i+32<=n;i+=32){
+                __m256i x=_mm256_loadu_si256((const __m256i *)(p+i));
+                // (x-'\t')<=4 无符号比较: min(x-'\t',4)==x-'\t'
+                __m256i d=_mm256_sub_epi8(x,tab);
+                __m256i ctrl=_mm256_cmpeq_epi8(_mm256_min_epu8(d,range),d);
+                __m256i ws=_mm256_or_si256(ctrl,_mm256_cmpeq_epi8(x,space));
+                unsigned mask=(unsigned)_mm256_movemask_epi8(ws);
+                if(mask!=0xFFFFFFFFu){
+                    return i+__builtin_ctz(~mask);
+                }
+            }
+            return i+skip_space_scalar(p+i,n-i);
+        }
+#endif
+
+        // 空白不同时每个token都要处理一次差异，之后相同的一段和空白通常只有几个字节，
+        // 对这样的短数据通过函数表调用SIMD内核反而比标量慢，
+        // 所以先用标量探测Probe字节，超过时再交给内核；完全相同的长段仍由内核处理
+        constexpr size_t Probe=32;
+        inline size_t mismatch_probe(const Kernel &k,const char *a,const char *b,size_t n){
+            size_t m=std::min(n,Probe);
+            size_t d=mismatch_scalar(a,b,m);
+            if(d<m||m==n){
+                return d;
+            }
+            return d+k.mismatch(a+d,b+d,n-d);
+        }
+        inline size_t skip_space_probe(const Kernel &k,const char *p,size_t n){
+            size_t m=std::min(n,Probe);
+            size_t i=skip_space_scalar(p,m);
+            if(i<m||m==n){
+                return i;
+            }
+            return i+k.skip_space(p+i,n-i);
+        }
+
+        const Kernel &get_kernel(CompareKernel kernel){
+            static const Kernel scalar{ mismatch_scalar,skip_space_scalar };
+#ifdef COMPARE_X86
+            static const Kernel sse42{ mismatch_sse42,skip_space_sse42 };
+            static const Kernel avx2{ mismatch_avx2,skip_space_avx2 };
+#endif
+            if(kernel==Kernel_Auto){
+                kernel=best_kernel();
+            }
+            switch(kernel){
+#ifdef COMPARE_X86
+            case Kernel_AVX2:
+                return avx2;
+            case Kernel_SSE42:
+                return sse42;
+#endif
+            default:
+                return scalar;
+            }
+        }
+
+        // 解析整个token为浮点数，不分配内存
+        bool parse_number(const char *first,const char *last,double &value){
+            if(first!=last&&*first=='+'){
+                first++;
+            }
+            auto [ptr,ec]=std::from_chars(first,last,value);
+            return ec==std::errc()&&ptr==last;
+        }
+        // 输出值x与答案值y是否在误差范围内
+        bool near(double x,double y,double absEps,double relEps){
+            if(std::isnan(x)||std::isnan(y)){
+                return std::isnan(x)&&std::isnan(y);
+            }
+            if(std::isinf(x)||std::isinf(y)){
+                return x==y;
+            }
+            double diff=std::fabs(x-y);
+            return diff<=absEps||diff<=relEps*std::fabs(y);
+        }
+
+        // 统计[0,end)中token的数量
+        size_t count_tokens(const char *p,size_t end){
+            size_t count=0;
+            bool inToken=false;
+            for(size_t i=0;i<end;i++){
+                bool space=is_space(p[i]);
+                if(!space&&!inToken){
+                    count++;
+                }
+                inToken=!space;
+            }
+            return count;
+        }
+    }
+
+    CompareKernel best_kernel(){
+#ifdef COMPARE_X86
+        static const CompareKernel best=[](){
+            __builtin_cpu_init();
+            if(__builtin_cpu_supports("avx2")){
+                return Kernel_AVX2;
+            }
+            if(__builtin_cpu_supports("sse4.2")){
+                return Kernel_SSE42;
+            }
+            return Kernel_Scalar;
+        }();
+        return best;
+#else
+        return Kernel_Scalar;
+#endif
+    }
+
+    string f(CompareKernel kernel){
+        switch(kernel){
+        case Kernel_Auto:
+            return "auto";
+        case Kernel_Scalar:
+            return "scalar";
+        case Kernel_SSE42:
+            return "sse4.2";
+        case Kernel_AVX2:
+            return "avx2";
+        default:
+            throw std::runtime_error("未知比较内核");
+        }
+    }
+
+    // 整块比较相同字节，只在出现差异时按token规则处理空白
+    CompareResult compare_tokens(const char *a,size_t lenA,const char *b,size_t lenB,CompareKernel kernel){
+        const Kernel &k=get_kernel(kernel);
+        size_t i=0,j=0;
+        // 当前是否处于两侧已匹配的token内部
+        bool inToken=false;
+        while(true){
+            size_t d=mismatch_probe(k,a+i,b+j,std::min(lenA-i,lenB-j));
+            if(d>0){
+                i+=d;
+                j+=d;
+                inToken=!is_space(a[i-1]);
+            }
+            bool endA=i==lenA,endB=j==lenB;
+            if(endA&&endB){
+                return CompareResult();
+            }
+            bool spaceA=endA||is_space(a[i]);
+            bool spaceB=endB||is_space(b[j]);
+            // 两侧token同时结束
+            if(spaceA&&spaceB){
+                i+=skip_space_probe(k,a+i,lenA-i);
+                j+=skip_space_probe(k,b+j,lenB-j);
+                inToken=false;
+                continue;
+            }
+            // token之间的空白长度不同
+            if(!inToken&&spaceA&&!endA){
+                i+=skip_space_probe(k,a+i,lenA-i);
+                continue;
+            }
+            if(!inToken&&spaceB&&!endB){
+                j+=skip_space_probe(k,b+j,lenB-j);
+                continue;
+            }
+            // 出现差异，回退到token起点
+            if(inToken){
+                while(i>0&&!is_space(a[i-1])){
+                    i--;
+                }
+                while(j>0&&!is_space(b[j-1])){
+                    j--;
+                }
+            }
+            CompareResult res;
+            res.same=false;
+            res.offsetA=i;
+            res.offsetB=j;
+            res.token=count_tokens(a,i);
+            return res;
+        }
+    }
+    CompareResult compare_tokens(const string &a,const string &b,CompareKernel kernel){
+        return compare_tokens(a.data(),a.size(),b.data(),b.size(),kernel);
+    }
+
+    // 逐token比较，相同字节的token不解析
+    CompareResult compare_numbers(const char *a,size_t lenA,const char *b,size_t lenB,double absEps,double relEps,CompareKernel kernel){
+        const Kernel &k=get_kernel(kernel);
+        size_t i=0,j=0;
+        CompareResult res;
+        while(true){
+            i+=skip_space_probe(k,a+i,lenA-i);
+            j+=skip_space_probe(k,b+j,lenB-j);
+            if(i==lenA||j==lenB){
+                if(i==lenA&&j==lenB){
+                    return CompareResult();
+                }
+                break;
+            }
+            size_t endA=i,endB=j;
+            while(endA<lenA&&!is_space(a[endA])){
+                endA++;
+            }
+            while(endB<lenB&&!is_space(b[endB])){
+                endB++;
+            }
+            if(endA-i!=endB-j||std::memcmp(a+i,b+j,endA-i)!=0){
+                double x,y;
+                if(!parse_number(a+i,a+endA,x)||!parse_number(b+j,b+endB,y)||!near(x,y,absEps,relEps)){
+                    break;
+                }
+            }
+            i=endA;
+            j=endB;
+            res.token++;
+        }
+        res.same=false;
+        res.offsetA=i;
+        res.offsetB=j;
+        return res;
+    }
+    CompareResult compare_numbers(const string &a,const string &b,double absEps,double relEps,CompareKernel kernel){
+        return compare_numbers(a.data(),a.size(),b.data(),b.size(),absEps,relEps,kernel);
+    }
+
+    // 流式比较
+    StreamCompare::StreamCompare(){}
+    StreamCompare::StreamCompare(double absEps,double relEps)
+        :_float(true),_absEps(absEps),_relEps(relEps){}
+
+    bool StreamCompare::feed(int side,const char *data,size_t len){
+        if(_done||len==0){
+            return _done;
+        }
+        // 已比较的部分超过一半时再丢弃，均摊拷贝开销
+        if(_pos[side]>_buf[side].size()/2){
+            _base[side]+=_pos[side];
+            _buf[side].erase(0,_pos[side]);
+            _pos[side]=0;
+        }
+        _buf[side].append(data,len);
+        advance();
+        return _done;
+    }
+    bool StreamCompare::close(int side){
+        _closed[side]=true;
+        if(!_done){
+            advance();
+        }
+        return _done;
+    }
+    bool StreamCompare::done() const{
+        return _done;
+    }
+    size_t StreamCompare::pending(int side) const{
+        return _buf[side].size()-_pos[side];
+    }
+    const CompareResult &StreamCompare::result() const{
+        return _res;
+    }
+    void StreamCompare::diverge(size_t i,size_t j){
+        _done=true;
+        _res.same=false;
+        _res.offsetA=_base[0]+i;
+        _res.offsetB=_base[1]+j;
+    }
+    // 每一步都停在token边界上，token未完整到达时等待更多数据
+    void StreamCompare::advance(){
+        const Kernel &k=get_kernel(Kernel_Auto);
+        const char *a=_buf[0].data(),*b=_buf[1].data();
+        size_t lenA=_buf[0].size(),lenB=_buf[1].size();
+        size_t &i=_pos[0],&j=_pos[1];
+        while(true){
+            // 相同字节整块跳过，只消耗到最后一个空白为止；上次已确认相同的部分不再比较
+            size_t d=_checked+mismatch_probe(k,a+i+_checked,b+j+_checked,std::min(lenA-i,lenB-j)-_checked);
+            size_t p=d;
+            while(p>_checked&&!is_space(a[i+p-1])){
+                p--;
+            }
+            // 已确认的部分都不是空白
+            if(p==_checked){
+                p=0;
+            }
+            _res.token+=count_tokens(a+i,p);
+            i+=p;
+            j+=p;
+            _checked=d-p;
+            // 跳过空白
+            i+=skip_space_probe(k,a+i,lenA-i);
+            j+=skip_space_probe(k,b+j,lenB-j);
+            bool endA=i==lenA,endB=j==lenB;
+            if((endA&&!_closed[0])||(endB&&!_closed[1])){
+                return;
+            }
+            if(endA||endB){
+                if(endA&&endB){
+                    _done=true;
+                    _res=CompareResult();
+                }
+                else{
+                    diverge(i,j);
+                }
+                return;
+            }
+            // 取出完整的token
+            size_t endTokenA=i+_checked,endTokenB=j+_checked;
+            while(endTokenA<lenA&&!is_space(a[endTokenA])){
+                endTokenA++;
+            }
+            while(endTokenB<lenB&&!is_space(b[endTokenB])){
+                endTokenB++;
+            }
+            if((endTokenA==lenA&&!_closed[0])||(endTokenB==lenB&&!_closed[1])){
+                return;
+            }
+            if(endTokenA-i!=endTokenB-j||std::memcmp(a+i,b+j,endTokenA-i)!=0){
+                double x,y;
+                if(!_float||!parse_number(a+i,a+endTokenA,x)||!parse_number(b+j,b+endTokenB,y)||!near(x,y,_absEps,_relEps)){
+                    diverge(i,j);
+                    return;
+                }
+            }
+            i=endTokenA;
+            j=endTokenB;
+            _checked=0;
+            _res.token++;
+        }
+    }
+}
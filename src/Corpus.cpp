@@ -0,0 +1,122 @@
+#include "Corpus.h"
+#include "Hash.h"
+#include "MappedFile.h"
+#include <fstream>
+#include <stdexcept>
+#include <zlib.h>
+
+namespace acm{
+    Corpus::Corpus(){}
+    fs::path Corpus::file_of(const string &hash) const{
+        return _dir/"objects"/hash.substr(0,2)/hash;
+    }
+    void Corpus::open(const fs::path &dir){
+        _dir=dir;
+        _sizes.clear();
+        _rawBytes=_packedBytes=0;
+        _puts=_shared=0;
+        fs::create_directories(dir/"objects");
+        _index.open(dir/"index.jsonl");
+        _index.for_each([&](size_t,const json &record){
+            string hash=record.value("hash",string());
+            // 写入内容后才追加索引，索引中的内容都已完整写入
+            if(!hash.empty()&&_sizes.emplace(hash,record.value("size",0ULL)).second){
+                _rawBytes+=record.value("size",0ULL);
+                _packedBytes+=record.value("packed",0ULL);
+            }
+        });
+    }
+    bool Corpus::is_open() const{
+        return _index.is_open();
+    }
+    string Corpus::compress(std::string_view data){
+        uLongf bound=compressBound(data.size());
+        string packed(8+bound,'\0');
+        uint64_t size=data.size();
+        for(int i=0;i<8;i++){
+            packed[i]=(char)(size>>(8*i)&0xff);
+        }
+        int res=compress2((Bytef *)packed.data()+8,&bound,(const Bytef *)data.data(),data.size(),Z_DEFAULT_COMPRESSION);
+        if(res!=Z_OK){
+            throw std::runtime_error("Corpus: 压缩失败");
+        }
+        packed.resize(8+bound);
+        return packed;
+    }
+    bool Corpus::decompress(std::string_view packed,string &data){
+        if(packed.size()<8){
+            return false;
+        }
+        uint64_t size=0;
+        for(int i=0;i<8;i++){
+            size|=(uint64_t)(unsigned char)packed[i]<<(8*i);
+        }
+        data.assign(size,'\0');
+        uLongf length=size;
+        int res=uncompress((Bytef *)data.data(),&length,(const Bytef *)packed.data()+8,packed.size()-8);
+        return res==Z_OK&&length==size;
+    }
+    string Corpus::put(std::string_view data){
+        if(!is_open()){
+            throw std::runtime_error("Corpus: 存储未打开");
+        }
+        string hash=hex64(hash64(data));
+        _puts++;
+        if(_sizes.count(hash)){
+            _shared++;
+            return hash;
+        }
+        string packed=compress(data);
+        fs::path file=file_of(hash);
+        fs::create_directories(file.parent_path());
+        // 先写入临时文件再改名，其他进程不会读到不完整的内容
+        fs::path temp=file;
+        temp+=".tmp";
+        std::ofstream out(temp,std::ios::binary|std::ios::trunc);
+        out.write(packed.data(),packed.size());
+        out.close();
+        if(!out){
+            throw std::runtime_error("Corpus: 写入文件失败: "+temp.string());
+        }
+        fs::rename(temp,file);
+        _index.append({ { "hash",hash },{ "size",data.size() },{ "packed",packed.size() } });
+        _sizes[hash]=data.size();
+        _rawBytes+=data.size();
+        _packedBytes+=packed.size();
+        return hash;
+    }
+    string Corpus::put_file(const fs::path &file){
+        MappedFile data(file);
+        return put(data.view());
+    }
+    bool Corpus::get(const string &hash,string &data) const{
+        if(!contains(hash)){
+            return false;
+        }
+        try{
+            MappedFile packed(file_of(hash));
+            return decompress(packed.view(),data)&&hex64(hash64(data))==hash;
+        }
+        catch(const std::exception &){
+            return false;
+        }
+    }
+    bool Corpus::contains(const string &hash) const{
+        return _sizes.count(hash)>0;
+    }
+    size_t Corpus::size() const{
+        return _sizes.size();
+    }
+    uint64_t Corpus::raw_bytes() const{
+        return _rawBytes;
+    }
+    uint64_t Corpus::packed_bytes() const{
+        return _packedBytes;
+    }
+    long long Corpus::puts() const{
+        return _puts;
+    }
+    long long Corpus::shared() const{
+        return _shared;
+    }
+}
@@ -0,0 +1,228 @@
+#include "Coverage.h"
+#include <stdexcept>
+#include <cstring>
+#include <cctype>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+namespace acm{
+    CoverageMap::CoverageMap(){}
+    void CoverageMap::open(const fs::path &file){
+        close();
+        int fd=::open(file.c_str(),O_RDWR|O_CREAT|O_TRUNC,0644);
+        if(fd==-1){
+            throw std::runtime_error("CoverageMap: 无法创建位图文件: "+file.string());
+        }
+        if(ftruncate(fd,Size)==-1){
+            ::close(fd);
+            throw std::runtime_error("CoverageMap: 无法设置位图文件大小: "+file.string());
+        }
+        void *addr=mmap(nullptr,Size,PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
+        ::close(fd);
+        if(addr==MAP_FAILED){
+            throw std::runtime_error("CoverageMap: 无法映射位图文件: "+file.string());
+        }
+        _file=file;
+        _map=static_cast<unsigned char *>(addr);
+        _seen.assign(Size,0);
+        _edges=0;
+    }
+    void CoverageMap::close(){
+        if(_map!=nullptr){
+            munmap(_map,Size);
+            _map=nullptr;
+        }
+    }
+    bool CoverageMap::is_open() const{
+        return _map!=nullptr;
+    }
+    const fs::path &CoverageMap::file() const{
+        return _file;
+    }
+    unsigned char *CoverageMap::data(){
+        return _map;
+    }
+    void CoverageMap::reset(){
+        memset(_map,0,Size);
+    }
+    // 次数按 1 2 3 4-7 8-15 16-31 32-127 128+ 分档，循环次数的数量级变化也算新的覆盖
+    static unsigned char count_class(unsigned char count){
+        if(count<=3){
+            return (unsigned char)(1<<(count-1));
+        }
+        if(count<=7){
+            return 8;
+        }
+        if(count<=15){
+            return 16;
+        }
+        if(count<=31){
+            return 32;
+        }
+        return count<=127?64:128;
+    }
+    size_t CoverageMap::merge(){
+        size_t found=0;
+        // 按8字节跳过全零的区域
+        for(size_t base=0;base<Size;base+=8){
+            uint64_t word;
+            memcpy(&word,_map+base,8);
+            if(word==0){
+                continue;
+            }
+            for(size_t i=base;i<base+8;i++){
+                if(_map[i]==0){
+                    continue;
+                }
+                unsigned char bit=count_class(_map[i]);
+                if((_seen[i]&bit)==0){
+                    if(_seen[i]==0){
+                        _edges++;
+                    }
+                    _seen[i]|=bit;
+                    found++;
+                }
+            }
+        }
+        return found;
+    }
+    size_t CoverageMap::edges() const{
+        return _edges;
+    }
+    const char *CoverageMap::runtime(){
+        return R"(// 边覆盖运行时，不插桩编译
+#include <cstdint>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+static unsigned char *acm_cov_map;
+static uintptr_t acm_cov_prev;
+extern "C" void __sanitizer_cov_trace_pc();
+__attribute__((constructor(101))) static void acm_cov_init(){
+    const char *file=getenv("ACM_COV_FILE");
+    if(file==nullptr){
+        return;
+    }
+    int fd=open(file,O_RDWR);
+    if(fd==-1){
+        return;
+    }
+    void *addr=mmap(nullptr,1<<16,PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
+    close(fd);
+    acm_cov_map=addr==MAP_FAILED?nullptr:static_cast<unsigned char *>(addr);
+}
+extern "C" void __sanitizer_cov_trace_pc(){
+    if(acm_cov_map==nullptr){
+        return;
+    }
+    // 相对本函数的偏移不受地址随机化影响
+    uintptr_t cur=(uintptr_t)__builtin_return_address(0)-(uintptr_t)&__sanitizer_cov_trace_pc;
+    cur=(cur>>4)^(cur<<8);
+    unsigned char &count=acm_cov_map[(cur^acm_cov_prev)&0xffff];
+    if(count<255){
+        count++;
+    }
+    acm_cov_prev=cur>>1;
+}
+)";
+    }
+    CoverageMap::~CoverageMap(){
+        close();
+    }
+    // 单元为空白或token
+    static std::vector<string> tokenize(const string &input){
+        std::vector<string> units;
+        size_t pos=0;
+        while(pos<input.size()){
+            size_t end=pos;
+            bool space=isspace((unsigned char)input[pos]);
+            while(end<input.size()&&(bool)isspace((unsigned char)input[end])==space){
+                end++;
+            }
+            units.push_back(input.substr(pos,end-pos));
+            pos=end;
+        }
+        return units;
+    }
+    static bool is_number(const string &token){
+        size_t pos=token[0]=='-'?1:0;
+        if(pos>=token.size()||token.size()-pos>18){
+            return false;
+        }
+        for(size_t i=pos;i<token.size();i++){
+            if(!isdigit((unsigned char)token[i])){
+                return false;
+            }
+        }
+        return true;
+    }
+    string mutate(const string &input,std::mt19937_64 &rng){
+        string res=input;
+        int rounds=std::uniform_int_distribution<int>(1,4)(rng);
+        for(int round=0;round<rounds;round++){
+            std::vector<string> units=tokenize(res);
+            std::vector<size_t> tokens,numbers;
+            for(size_t i=0;i<units.size();i++){
+                if(!isspace((unsigned char)units[i][0])){
+                    tokens.push_back(i);
+                    if(is_number(units[i])){
+                        numbers.push_back(i);
+                    }
+                }
+            }
+            if(tokens.empty()){
+                break;
+            }
+            auto pick=[&](const std::vector<size_t> &from){
+                return from[std::uniform_int_distribution<size_t>(0,from.size()-1)(rng)];
+            };
+            int op=std::uniform_int_distribution<int>(0,4)(rng);
+            if(op<=1&&!numbers.empty()){
+                size_t i=pick(numbers);
+                long long value=std::stoll(units[i]);
+                if(op==0){
+                    value+=std::uniform_int_distribution<int>(-2,2)(rng);
+                }
+                else{
+                    // 边界值
+                    const long long edges[]={ 0,1,-1,value*2,value/2,-value };
+                    value=edges[std::uniform_int_distribution<int>(0,5)(rng)];
+                }
+                units[i]=std::to_string(value);
+            }
+            else if(op==2){
+                units[pick(tokens)]=units[pick(tokens)];
+            }
+            else{
+                // 按行重复或删除
+                std::vector<string> lines;
+                std::string joined;
+                for(const auto &unit:units){
+                    joined+=unit;
+                }
+                size_t pos=0;
+                while(pos<joined.size()){
+                    size_t end=joined.find('\n',pos);
+                    end=end==string::npos?joined.size():end+1;
+                    lines.push_back(joined.substr(pos,end-pos));
+                    pos=end;
+                }
+                size_t i=std::uniform_int_distribution<size_t>(0,lines.size()-1)(rng);
+                if(op==3){
+                    lines.insert(lines.begin()+i,lines[i]);
+                }
+                else if(lines.size()>1){
+                    lines.erase(lines.begin()+i);
+                }
+                units=lines;
+            }
+            res.clear();
+            for(const auto &unit:units){
+                res+=unit;
+            }
+        }
+        return res;
+    }
+}
@@ -0,0 +1,100 @@
+#include "FailureBuckets.h"
+#include <cctype>
+#include <sys/wait.h>
+
+namespace acm{
+    FailureBuckets::FailureBuckets(size_t samples,size_t limit):_samples(samples),_limit(limit){}
+    bool FailureBuckets::add(const string &signature,const string &dataName){
+        _total++;
+        auto it=_buckets.find(signature);
+        if(it==_buckets.end()){
+            if(_buckets.size()>=_limit){
+                _overflow++;
+                return false;
+            }
+            it=_buckets.emplace(signature,Bucket()).first;
+        }
+        Bucket &bucket=it->second;
+        bucket.count++;
+        if(bucket.exemplars.size()>=_samples){
+            return false;
+        }
+        bucket.exemplars.push_back(dataName);
+        return true;
+    }
+    const std::map<string,FailureBuckets::Bucket> &FailureBuckets::buckets() const{
+        return _buckets;
+    }
+    long long FailureBuckets::total() const{
+        return _total;
+    }
+    long long FailureBuckets::overflow() const{
+        return _overflow;
+    }
+    string FailureBuckets::token_class(std::string_view token){
+        if(token.empty()){
+            return "缺失";
+        }
+        size_t pos=token[0]=='-'||token[0]=='+'?1:0;
+        bool digits=false,dot=false,zero=true;
+        for(size_t i=pos;i<token.size();i++){
+            char c=token[i];
+            if(isdigit((unsigned char)c)){
+                digits=true;
+                zero=zero&&c=='0';
+            }
+            else if(c=='.'||c=='e'||c=='E'||((c=='-'||c=='+')&&(token[i-1]=='e'||token[i-1]=='E'))){
+                dot=true;
+            }
+            else{
+                return "字符串";
+            }
+        }
+        if(!digits){
+            return "字符串";
+        }
+        if(dot){
+            return "小数";
+        }
+        if(zero){
+            return "零";
+        }
+        return token[0]=='-'?"负数":"正数";
+    }
+    string FailureBuckets::position_class(size_t token){
+        if(token<2){
+            return "#"+std::to_string(token);
+        }
+        size_t low=1;
+        while(low*2<=token){
+            low*=2;
+        }
+        return "#"+std::to_string(low)+"-"+std::to_string(low*2-1);
+    }
+    // 从偏移处取一个token
+    static std::string_view token_at(std::string_view data,size_t offset){
+        size_t end=offset;
+        while(end<data.size()&&!isspace((unsigned char)data[end])){
+            end++;
+        }
+        return offset<data.size()?data.substr(offset,end-offset):std::string_view();
+    }
+    string FailureBuckets::signature(JudgeCode status,int exitCode,const CompareResult &cmp,std::string_view out,std::string_view ac){
+        string res=f(status);
+        if(status==RuntimeError||status==FloatingPointError){
+            if(WIFSIGNALED(exitCode)){
+                res+=" 信号"+std::to_string(WTERMSIG(exitCode));
+            }
+            else if(WIFEXITED(exitCode)){
+                res+=" 退出码"+std::to_string(WEXITSTATUS(exitCode));
+            }
+            return res;
+        }
+        if((status==WrongAnswer||status==PresentationError)&&!cmp.same){
+            res+=" "+position_class(cmp.token)+
+                " "+token_class(token_at(out,cmp.offsetA))+
+                "/"+token_class(token_at(ac,cmp.offsetB));
+        }
+        return res;
+    }
+}
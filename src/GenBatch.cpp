@@ -0,0 +1,56 @@
+#include "GenBatch.h"
+#include <algorithm>
+#include <cmath>
+
+namespace acm{
+    int GenBatch::count(int fixed,long long left) const{
+        int size=fixed>0?fixed:_batch;
+        return (int)std::max<long long>(1,std::min<long long>(size,left));
+    }
+    bool GenBatch::tune(int count,double cost){
+        if(_tuned){
+            return false;
+        }
+        if(count==1){
+            _single=cost;
+            _batch=8;
+            return false;
+        }
+        // 启动开销占比 overhead/(overhead+n*per)<=1/20 即 n>=19*overhead/per
+        _per=std::max((cost-_single)/(count-1),1e-6);
+        _overhead=std::max(_single-_per,0.0);
+        _batch=std::clamp((int)std::ceil(19*_overhead/_per),1,1024);
+        _tuned=true;
+        return true;
+    }
+    bool GenBatch::tuned() const{
+        return _tuned;
+    }
+    double GenBatch::overhead() const{
+        return _overhead;
+    }
+    double GenBatch::per() const{
+        return _per;
+    }
+    bool GenBatch::ready(long long seed,long long size) const{
+        return !_queue.empty()&&_queue.front()==seed&&_size==size;
+    }
+    void GenBatch::fill(long long seed,int count,long long size){
+        _queue.clear();
+        for(int i=0;i<count;i++){
+            _queue.push_back(seed+i);
+        }
+        _size=size;
+    }
+    void GenBatch::pop(){
+        if(!_queue.empty()){
+            _queue.pop_front();
+        }
+    }
+    void GenBatch::clear(){
+        _queue.clear();
+    }
+    size_t GenBatch::pending() const{
+        return _queue.size();
+    }
+}
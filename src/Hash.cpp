@@ -0,0 +1,177 @@
+#include "Hash.h"
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+
+namespace acm{
+    namespace{
+        const uint64_t Prime1=0x9E3779B185EBCA87ULL;
+        const uint64_t Prime2=0xC2B2AE3D27D4EB4FULL;
+        const uint64_t Prime3=0x165667B19E3779F9ULL;
+        const uint64_t Prime4=0x85EBCA77C2B2AE63ULL;
+        const uint64_t Prime5=0x27D4EB2F165667C5ULL;
+        inline uint64_t rotl(uint64_t x,int r){
+            return (x<<r)|(x>>(64-r));
+        }
+        // 未对齐读取，按小端处理
+        inline uint64_t read64(const unsigned char *p){
+            uint64_t v;
+            memcpy(&v,p,sizeof(v));
+            return v;
+        }
+        inline uint32_t read32(const unsigned char *p){
+            uint32_t v;
+            memcpy(&v,p,sizeof(v));
+            return v;
+        }
+        inline uint64_t round(uint64_t acc,uint64_t input){
+            acc+=input*Prime2;
+            acc=rotl(acc,31);
+            return acc*Prime1;
+        }
+        inline uint64_t merge(uint64_t acc,uint64_t val){
+            acc^=round(0,val);
+            return acc*Prime1+Prime4;
+        }
+    }
+    uint64_t hash64(const void *data,size_t len,uint64_t seed){
+        const unsigned char *p=static_cast<const unsigned char *>(data);
+        const unsigned char *end=p+len;
+        uint64_t h;
+        // 每32字节4路并行累加
+        if(len>=32){
+            uint64_t v1=seed+Prime1+Prime2;
+            uint64_t v2=seed+Prime2;
+            uint64_t v3=seed;
+            uint64_t v4=seed-Prime1;
+            const unsigned char *limit=end-32;
+            do{
+                v1=round(v1,read64(p));
+                v2=round(v2,read64(p+8));
+                v3=round(v3,read64(p+16));
+                v4=round(v4,read64(p+24));
+                p+=32;
+            }while(p<=limit);
+            h=rotl(v1,1)+rotl(v2,7)+rotl(v3,12)+rotl(v4,18);
+            h=merge(h,v1);
+            h=merge(h,v2);
+            h=merge(h,v3);
+            h=merge(h,v4);
+        }
+        else{
+            h=seed+Prime5;
+        }
+        h+=len;
+        // 处理剩余字节
+        while(p+8<=end){
+            h^=round(0,read64(p));
+            h=rotl(h,27)*Prime1+Prime4;
+            p+=8;
+        }
+        if(p+4<=end){
+            h^=(uint64_t)read32(p)*Prime1;
+            h=rotl(h,23)*Prime2+Prime3;
+            p+=4;
+        }
+        while(p<end){
+            h^=(*p)*Prime5;
+            h=rotl(h,11)*Prime1;
+            p++;
+        }
+        // 雪崩
+        h^=h>>33;
+        h*=Prime2;
+        h^=h>>29;
+        h*=Prime3;
+        h^=h>>32;
+        return h;
+    }
+    uint64_t hash64(std::string_view data,uint64_t seed){
+        return hash64(data.data(),data.size(),seed);
+    }
+    string hex64(uint64_t hash){
+        char buffer[17];
+        snprintf(buffer,sizeof(buffer),"%016llx",(unsigned long long)hash);
+        return buffer;
+    }
+
+    SeenSet::SeenSet(size_t limit):_limit(limit){}
+    bool SeenSet::insert(uint64_t hash){
+        if(_layers.empty()){
+            if(!_exact.insert(hash).second){
+                return false;
+            }
+            _count++;
+            // 超过上限后转为布隆过滤器
+            if(_exact.size()>_limit){
+                add_layer();
+                for(uint64_t value:_exact){
+                    bloom_insert(value);
+                }
+                std::unordered_set<uint64_t>().swap(_exact);
+            }
+            return true;
+        }
+        if(bloom_insert(hash)){
+            return false;
+        }
+        _count++;
+        return true;
+    }
+    // 第i层容量为2*limit*2^i，每个元素16+4i位、4+i次探测:
+    // 每层的误判率约为 (1-e^(-1/4))^(4+i)，逐层以0.22倍递减，各层之和约为0.3%
+    void SeenSet::add_layer(){
+        size_t i=_layers.size();
+        Layer layer;
+        layer.capacity=(std::max<size_t>(_limit,64)*2)<<i;
+        layer.probes=4+(int)i;
+        layer.bits.assign((layer.capacity*(16+4*i)+63)/64,0);
+        _layers.push_back(std::move(layer));
+    }
+    bool SeenSet::probe(Layer &layer,uint64_t hash,bool set){
+        uint64_t bits=layer.bits.size()*64;
+        // 双重哈希生成探测位置
+        uint64_t h1=hash,h2=rotl(hash,32)|1;
+        bool found=true;
+        for(int i=0;i<layer.probes;i++){
+            uint64_t pos=(h1+i*h2)%bits;
+            uint64_t mask=1ULL<<(pos%64);
+            if(!(layer.bits[pos/64]&mask)){
+                if(!set){
+                    return false;
+                }
+                found=false;
+                layer.bits[pos/64]|=mask;
+            }
+        }
+        return found;
+    }
+    bool SeenSet::bloom_insert(uint64_t hash){
+        if(_layers.back().count>=_layers.back().capacity){
+            add_layer();
+        }
+        // 之前的层只查询，新元素插入最后一层
+        for(size_t i=0;i+1<_layers.size();i++){
+            if(probe(_layers[i],hash,false)){
+                return true;
+            }
+        }
+        Layer &last=_layers.back();
+        if(probe(last,hash,true)){
+            return true;
+        }
+        last.count++;
+        return false;
+    }
+    size_t SeenSet::size() const{
+        return _count;
+    }
+    bool SeenSet::is_bloom() const{
+        return !_layers.empty();
+    }
+    void SeenSet::clear(){
+        std::unordered_set<uint64_t>().swap(_exact);
+        std::vector<Layer>().swap(_layers);
+        _count=0;
+    }
+}
@@ -0,0 +1,150 @@
+#include "JsonlStore.h"
+#include "MappedFile.h"
+#include <fstream>
+#include <cstring>
+#include <stdexcept>
+
+namespace acm{
+    // 替换记录的行首，格式为{"_replaces":i,"record":记录}，由write_line前手工拼接，不依赖键的排序
+    static const char replacesPrefix[]="{\"_replaces\":";
+    // 更新部分字段的行首，格式为{"_updates":i,"fields":字段}
+    static const char updatesPrefix[]="{\"_updates\":";
+
+    JsonlStore::JsonlStore(){}
+    void JsonlStore::open(const fs::path &file){
+        _path=file;
+        _index.clear();
+        _updates.clear();
+        _end=0;
+        if(!fs::exists(file)){
+            std::ofstream create(file,std::ios::binary);
+            if(!create.is_open()){
+                throw std::runtime_error("JsonlStore: 无法创建文件: "+file.string());
+            }
+            return;
+        }
+        MappedFile data(file);
+        const char *begin=data.data();
+        size_t size=data.size();
+        size_t pos=0;
+        // 只查找换行和替换记录的行首，不解析内容
+        while(pos<size){
+            const char *newline=(const char *)memchr(begin+pos,'\n',size-pos);
+            if(newline==nullptr){
+                break;
+            }
+            size_t end=newline-begin;
+            Line line{ pos,end-pos };
+            size_t prefix=sizeof(replacesPrefix)-1;
+            size_t updates=sizeof(updatesPrefix)-1;
+            if(line.length>prefix&&memcmp(begin+pos,replacesPrefix,prefix)==0){
+                size_t target=strtoull(begin+pos+prefix,nullptr,10);
+                if(target<_index.size()){
+                    line.wrapped=true;
+                    _index[target]=line;
+                    _updates[target].clear();
+                }
+            }
+            else if(line.length>updates&&memcmp(begin+pos,updatesPrefix,updates)==0){
+                size_t target=strtoull(begin+pos+updates,nullptr,10);
+                if(target<_index.size()){
+                    _updates[target].push_back(line);
+                }
+            }
+            else if(line.length>0){
+                _index.push_back(line);
+                _updates.emplace_back();
+            }
+            pos=end+1;
+        }
+        _end=pos;
+        if(pos<size){
+            data.close();
+            fs::resize_file(file,pos);
+        }
+    }
+    bool JsonlStore::is_open() const{
+        return !_path.empty();
+    }
+    const fs::path &JsonlStore::path() const{
+        return _path;
+    }
+    JsonlStore::Line JsonlStore::write_line(const string &line){
+        if(!is_open()){
+            throw std::runtime_error("JsonlStore: 文件未打开");
+        }
+        std::ofstream file(_path,std::ios::binary|std::ios::app);
+        file<<line<<'\n';
+        file.close();
+        if(!file){
+            throw std::runtime_error("JsonlStore: 写入文件失败: "+_path.string());
+        }
+        Line res{ _end,line.size(),false };
+        _end+=line.size()+1;
+        return res;
+    }
+    size_t JsonlStore::append(const json &record){
+        // 以该键开头的行会被当作替换记录
+        if(record.contains("_replaces")||record.contains("_updates")){
+            throw std::invalid_argument("JsonlStore: 记录不能包含_replaces或_updates字段");
+        }
+        _index.push_back(write_line(record.dump()));
+        _updates.emplace_back();
+        return _index.size()-1;
+    }
+    void JsonlStore::replace(size_t i,const json &record){
+        if(i>=_index.size()){
+            throw std::out_of_range("JsonlStore: 记录序号越界");
+        }
+        Line line=write_line(replacesPrefix+std::to_string(i)+",\"record\":"+record.dump()+"}");
+        line.wrapped=true;
+        _index[i]=line;
+        _updates[i].clear();
+    }
+    void JsonlStore::update(size_t i,const json &fields){
+        if(i>=_index.size()){
+            throw std::out_of_range("JsonlStore: 记录序号越界");
+        }
+        _updates[i].push_back(write_line(updatesPrefix+std::to_string(i)+",\"fields\":"+fields.dump()+"}"));
+    }
+    size_t JsonlStore::size() const{
+        return _index.size();
+    }
+    bool JsonlStore::empty() const{
+        return _index.empty();
+    }
+    json JsonlStore::read_line(std::istream &in,const Line &line) const{
+        string data(line.length,'\0');
+        in.seekg(line.offset);
+        in.read(data.data(),line.length);
+        json record=json::parse(data);
+        if(line.wrapped){
+            return record["record"];
+        }
+        return record;
+    }
+    json JsonlStore::read_record(std::istream &in,size_t i) const{
+        json record=read_line(in,_index[i]);
+        // 按写入顺序合并更新的字段
+        for(const auto &line:_updates[i]){
+            record.update(read_line(in,line)["fields"]);
+        }
+        return record;
+    }
+    json JsonlStore::at(size_t i) const{
+        if(i>=_index.size()){
+            throw std::out_of_range("JsonlStore: 记录序号越界");
+        }
+        std::ifstream in(_path,std::ios::binary);
+        return read_record(in,i);
+    }
+    json JsonlStore::back() const{
+        return at(_index.size()-1);
+    }
+    void JsonlStore::for_each(const std::function<void(size_t,const json &)> &visit) const{
+        std::ifstream in(_path,std::ios::binary);
+        for(size_t i=0;i<_index.size();i++){
+            visit(i,read_record(in,i));
+        }
+    }
+}
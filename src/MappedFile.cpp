@@ -0,0 +1,80 @@
+#include "MappedFile.h"
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace acm{
+    MappedFile::MappedFile(){}
+    MappedFile::MappedFile(const fs::path &file){
+        open(file);
+    }
+    MappedFile::MappedFile(MappedFile &&other) noexcept
+        :_data(other._data),_size(other._size){
+        other._data=nullptr;
+        other._size=0;
+    }
+    MappedFile &MappedFile::operator=(MappedFile &&other) noexcept{
+        if(this!=&other){
+            unmap();
+            _data=other._data;
+            _size=other._size;
+            other._data=nullptr;
+            other._size=0;
+        }
+        return *this;
+    }
+    // 映射文件
+    void MappedFile::open(const fs::path &file){
+        unmap();
+        int fd=::open(file.c_str(),O_RDONLY|O_CLOEXEC);
+        if(fd==-1){
+            throw std::runtime_error("MappedFile: 无法打开文件: "+file.string());
+        }
+        struct stat st;
+        if(fstat(fd,&st)==-1){
+            ::close(fd);
+            throw std::runtime_error("MappedFile: 无法获取文件大小: "+file.string());
+        }
+        // 空文件不能映射
+        if(st.st_size>0){
+            void *addr=mmap(nullptr,st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+            if(addr==MAP_FAILED){
+                ::close(fd);
+                throw std::runtime_error("MappedFile: 映射文件失败: "+file.string());
+            }
+            // 顺序读取，提示内核预读
+            madvise(addr,st.st_size,MADV_SEQUENTIAL);
+            _data=static_cast<char *>(addr);
+            _size=st.st_size;
+        }
+        // 映射建立后即可关闭描述符
+        ::close(fd);
+    }
+    void MappedFile::close(){
+        unmap();
+    }
+    void MappedFile::unmap(){
+        if(_data!=nullptr){
+            munmap(_data,_size);
+        }
+        _data=nullptr;
+        _size=0;
+    }
+    const char *MappedFile::data() const{
+        return _data;
+    }
+    size_t MappedFile::size() const{
+        return _size;
+    }
+    bool MappedFile::empty() const{
+        return _size==0;
+    }
+    std::string_view MappedFile::view() const{
+        return std::string_view(_data,_size);
+    }
+    MappedFile::~MappedFile(){
+        unmap();
+    }
+}
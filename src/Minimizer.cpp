@@ -0,0 +1,134 @@
+#include "Minimizer.h"
+#include <atomic>
+#include <thread>
+#include <stdexcept>
+#include <cctype>
+
+namespace acm{
+    Minimizer::Minimizer(Test test,int jobs,long long limit):_test(std::move(test)),_jobs(jobs),_limit(limit){
+        if(jobs<=0){
+            throw std::runtime_error("Minimizer: 线程数必须为正");
+        }
+    }
+    // 每行连同换行符为一个单元；每个token连同其后的空白为一个单元，开头的空白单独为一个单元
+    std::vector<string> Minimizer::split(const string &input,Granularity granularity){
+        std::vector<string> units;
+        size_t pos=0;
+        if(granularity==Granularity_Line){
+            while(pos<input.size()){
+                size_t end=input.find('\n',pos);
+                end=end==string::npos?input.size():end+1;
+                units.push_back(input.substr(pos,end-pos));
+                pos=end;
+            }
+            return units;
+        }
+        while(pos<input.size()&&isspace((unsigned char)input[pos])){
+            pos++;
+        }
+        if(pos>0){
+            units.push_back(input.substr(0,pos));
+        }
+        while(pos<input.size()){
+            size_t end=pos;
+            while(end<input.size()&&!isspace((unsigned char)input[end])){
+                end++;
+            }
+            while(end<input.size()&&isspace((unsigned char)input[end])){
+                end++;
+            }
+            units.push_back(input.substr(pos,end-pos));
+            pos=end;
+        }
+        return units;
+    }
+    string Minimizer::join(const std::vector<string> &units){
+        string res;
+        for(const auto &unit:units){
+            res+=unit;
+        }
+        return res;
+    }
+    long long Minimizer::first_failing(const std::vector<std::vector<string>> &candidates){
+        long long count=(long long)candidates.size();
+        if(_limit>0){
+            count=std::min(count,_limit-_tests);
+        }
+        if(count<=0){
+            return -1;
+        }
+        std::vector<string> inputs(count);
+        for(long long i=0;i<count;i++){
+            inputs[i]=join(candidates[i]);
+        }
+        // 按序号依次领取候选，已有失败候选时不再领取序号更大的
+        std::atomic<long long> next{ 0 },found{ count };
+        std::atomic<long long> tested{ 0 };
+        auto work=[&](int worker){
+            while(true){
+                long long i=next++;
+                if(i>=count||i>=found){
+                    return;
+                }
+                tested++;
+                if(_test(inputs[i],worker)){
+                    long long cur=found;
+                    while(i<cur&&!found.compare_exchange_weak(cur,i)){}
+                }
+            }
+        };
+        int jobs=(int)std::min<long long>(_jobs,count);
+        std::vector<std::thread> threads;
+        for(int k=1;k<jobs;k++){
+            threads.emplace_back(work,k);
+        }
+        work(0);
+        for(auto &thread:threads){
+            thread.join();
+        }
+        _tests+=tested;
+        return found<count?found.load():-1;
+    }
+    std::vector<string> Minimizer::ddmin(std::vector<string> units){
+        size_t n=2;
+        while(units.size()>=2){
+            // 分成n块
+            std::vector<std::vector<string>> subsets,complements;
+            size_t len=units.size();
+            for(size_t k=0;k<n;k++){
+                size_t begin=len*k/n,end=len*(k+1)/n;
+                subsets.emplace_back(units.begin()+begin,units.begin()+end);
+                std::vector<string> rest(units.begin(),units.begin()+begin);
+                rest.insert(rest.end(),units.begin()+end,units.end());
+                complements.push_back(std::move(rest));
+            }
+            // 先试单独一块，再试去掉一块；两块时二者相同
+            std::vector<std::vector<string>> candidates=subsets;
+            if(n>2){
+                candidates.insert(candidates.end(),complements.begin(),complements.end());
+            }
+            long long i=first_failing(candidates);
+            if(i>=0&&(size_t)i<n){
+                units=std::move(candidates[i]);
+                n=2;
+            }
+            else if(i>=0){
+                units=std::move(candidates[i]);
+                n=std::max<size_t>(n-1,2);
+            }
+            else if(n<len&&(_limit<=0||_tests<_limit)){
+                n=std::min(n*2,len);
+            }
+            else{
+                break;
+            }
+        }
+        return units;
+    }
+    string Minimizer::minimize(const string &input,Granularity granularity){
+        return join(ddmin(split(input,granularity)));
+    }
+    long long Minimizer::tests() const{
+        return _tests;
+    }
+}
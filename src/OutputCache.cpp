@@ -0,0 +1,123 @@
+#include "OutputCache.h"
+#include "Hash.h"
+#include <vector>
+#include <algorithm>
+
+namespace acm{
+    OutputCache::OutputCache(){}
+    fs::path OutputCache::file_of(uint64_t key) const{
+        return _dir/(hex64(key)+".out");
+    }
+    void OutputCache::open(const fs::path &dir,uintmax_t capacity){
+        _dir=dir;
+        _capacity=capacity;
+        _bytes=0;
+        _tick=0;
+        _entries.clear();
+        _hits=_misses=_evictions=0;
+        if(!enabled()){
+            return;
+        }
+        fs::create_directories(dir);
+        std::vector<std::pair<fs::file_time_type,uint64_t>> order;
+        for(const auto &item:fs::directory_iterator(dir)){
+            const fs::path &path=item.path();
+            if(!item.is_regular_file()||path.extension()!=".out"){
+                continue;
+            }
+            // 不完整的写入和其他文件名不是合法的键
+            string name=path.stem().string();
+            if(name.size()!=16||name.find_first_not_of("0123456789abcdef")!=string::npos){
+                continue;
+            }
+            uint64_t key=std::stoull(name,nullptr,16);
+            _entries[key].size=item.file_size();
+            _bytes+=item.file_size();
+            order.emplace_back(item.last_write_time(),key);
+        }
+        std::sort(order.begin(),order.end());
+        for(const auto &[time,key]:order){
+            _entries[key].tick=++_tick;
+        }
+        if(_bytes>_capacity){
+            evict();
+        }
+    }
+    bool OutputCache::enabled() const{
+        return _capacity>0;
+    }
+    bool OutputCache::get(uint64_t key,const fs::path &target){
+        auto it=_entries.find(key);
+        if(it==_entries.end()){
+            _misses++;
+            return false;
+        }
+        std::error_code ec;
+        fs::copy_file(file_of(key),target,fs::copy_options::overwrite_existing,ec);
+        if(ec){
+            // 文件被外部删除，视为未命中
+            _bytes-=it->second.size;
+            _entries.erase(it);
+            _misses++;
+            return false;
+        }
+        it->second.tick=++_tick;
+        fs::last_write_time(file_of(key),fs::file_time_type::clock::now(),ec);
+        _hits++;
+        return true;
+    }
+    void OutputCache::put(uint64_t key,const fs::path &source){
+        uintmax_t size=fs::file_size(source);
+        if(!enabled()||size>_capacity){
+            return;
+        }
+        // 先写入临时文件再改名，中断时不会留下不完整的输出
+        fs::path temp=_dir/(hex64(key)+".tmp");
+        fs::copy_file(source,temp,fs::copy_options::overwrite_existing);
+        fs::rename(temp,file_of(key));
+        auto it=_entries.find(key);
+        if(it!=_entries.end()){
+            _bytes-=it->second.size;
+        }
+        _entries[key]={ size,++_tick };
+        _bytes+=size;
+        if(_bytes>_capacity){
+            evict();
+        }
+    }
+    void OutputCache::evict(){
+        std::vector<std::pair<uint64_t,uint64_t>> order;
+        order.reserve(_entries.size());
+        for(const auto &[key,entry]:_entries){
+            order.emplace_back(entry.tick,key);
+        }
+        std::sort(order.begin(),order.end());
+        // 留出余量，避免每次写入都重新排序
+        uintmax_t target=_capacity/10*9;
+        for(const auto &[tick,key]:order){
+            if(_bytes<=target){
+                break;
+            }
+            std::error_code ec;
+            fs::remove(file_of(key),ec);
+            _bytes-=_entries[key].size;
+            _entries.erase(key);
+            _evictions++;
+        }
+    }
+    size_t OutputCache::size() const{
+        return _entries.size();
+    }
+    uintmax_t OutputCache::bytes() const{
+        return _bytes;
+    }
+    long long OutputCache::hits() const{
+        return _hits;
+    }
+    long long OutputCache::misses() const{
+        return _misses;
+    }
+    long long OutputCache::evictions() const{
+        return _evictions;
+    }
+}
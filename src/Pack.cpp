@@ -0,0 +1,24 @@
+#include "Pack.h"
+#include <algorithm>
+
+namespace acm{
+    std::vector<size_t> pack_order(const std::vector<long long> &cases,long long line,int packLines){
+        std::vector<size_t> order;
+        if(line>=0){
+            long long sub=line/std::max(1,packLines);
+            for(size_t i=0;i<cases.size();i++){
+                if(sub<cases[i]){
+                    order.push_back(i);
+                    break;
+                }
+                sub-=cases[i];
+            }
+        }
+        for(size_t i=0;i<cases.size();i++){
+            if(order.empty()||order[0]!=i){
+                order.push_back(i);
+            }
+        }
+        return order;
+    }
+}
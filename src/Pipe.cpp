@@ -26,7 +26,8 @@ namespace process{
     }
     // 创建管道
     void Pipe::create(){
-        if(::pipe(_pipe)==-1){
+        // 设置O_CLOEXEC，避免其他子进程继承管道导致无法读到EOF
+        if(::pipe2(_pipe,O_CLOEXEC)==-1){
             throw std::runtime_error("Failed to create pipe");
         }
         _pipeType=true;
@@ -47,6 +48,8 @@ namespace process{
         if(!is_closed(PIPE_WRITE)){
             ::close(_pipe[PIPE_WRITE]);
         }
+        // 置为无效句柄，防止描述符被复用后误关闭
+        _pipe[PIPE_READ]=_pipe[PIPE_WRITE]=INVALID_HANDLE_VALUE;
     }
     // 设置阻塞模式
     void Pipe::set_blocked(bool isblocked){
@@ -88,6 +91,7 @@ namespace process{
         if(autoClose){
             // 关闭另一个管道
             ::close(_pipe[!_pipeType]);
+            _pipe[!_pipeType]=INVALID_HANDLE_VALUE;
         }
     }
     // 设置缓冲区大小
@@ -81,6 +81,27 @@ namespace process{
             _stdout.redirect(STDOUT_FILENO);
             _stderr.redirect(STDERR_FILENO);
 
+            // 文件重定向
+            if(!_inFile.empty()){
+                int fd=open(_inFile.c_str(),O_RDONLY);
+                if(fd==-1||dup2(fd,STDIN_FILENO)==-1){
+                    exit(EXIT_FAILURE);
+                }
+                ::close(fd);
+            }
+            if(!_outFile.empty()){
+                int fd=open(_outFile.c_str(),O_WRONLY|O_CREAT|O_TRUNC,0644);
+                if(fd==-1||dup2(fd,STDOUT_FILENO)==-1){
+                    exit(EXIT_FAILURE);
+                }
+                ::close(fd);
+            }
+
+            // 切换工作目录
+            if(!_workDir.empty()&&chdir(_workDir.c_str())==-1){
+                exit(EXIT_FAILURE);
+            }
+
             // 通讯 进程开始
             _child_message.set_type(PIPE_WRITE);
             _child_message<<"Start"<<std::endl;
@@ -146,10 +167,18 @@ namespace process{
     }
 
     Status Process::wait(){
+        // 没有可回收的子进程，避免waitpid(-1)回收其他子进程
+        if(_pid<=0){
+            return _status;
+        }
         int status;
-        waitpid(_pid,&status,0);
+        struct rusage usage{};
+        wait4(_pid,&status,0,&usage);
         _exit_code=status;
+        _cpu_time=usage.ru_utime.tv_sec+usage.ru_stime.tv_sec+(usage.ru_utime.tv_usec+usage.ru_stime.tv_usec)/1e6;
         _pid=-1;
+        // 停止计时
+        _timer.stop();
         if(_status==TIMEOUT){
             return _status;
         }
@@ -173,16 +202,16 @@ namespace process{
             _status=RE;
             return _status;
         }
-        // 停止计时
-        if(_status!=RUNNING){
-            _timer.stop();
-        }
     }
 
     int Process::get_exit_code() const{
         return _exit_code;
     }
 
+    double Process::get_cpu_time() const{
+        return _cpu_time;
+    }
+
     Status Process::get_status() const{
         return _status;
     }
@@ -249,6 +278,19 @@ namespace process{
         }
     }
 
+    Handle Process::get_handle(PipeType type){
+        if(type==PIPE_IN){
+            return _stdin.get_handle();
+        }
+        else if(type==PIPE_OUT){
+            return _stdout.get_handle();
+        }
+        else if(type==PIPE_ERR){
+            return _stderr.get_handle();
+        }
+        throw std::invalid_argument(name+":未知管道类型！");
+    }
+
     void Process::set_block(bool status){
         // 设置所有管道的阻塞状态
         _stdin.set_blocked(status);
@@ -362,6 +404,24 @@ namespace process{
         wait();
     }
 
+    Process &Process::set_redirect(PipeType type,const string &file){
+        if(type==PIPE_IN){
+            _inFile=file;
+        }
+        else if(type==PIPE_OUT){
+            _outFile=file;
+        }
+        else{
+            throw std::invalid_argument(name+":只能重定向标准输入输出！");
+        }
+        return *this;
+    }
+
+    Process &Process::set_workdir(const string &dir){
+        _workDir=dir;
+        return *this;
+    }
+
     Process &Process::set_env(const std::string &name,const std::string &value){
         _env_vars[name]=value;
         return *this;
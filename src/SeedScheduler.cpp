@@ -0,0 +1,37 @@
+#include "SeedScheduler.h"
+#include <stdexcept>
+
+namespace acm{
+    SeedScheduler::SeedScheduler(){}
+    SeedScheduler::SeedScheduler(long long base,int worker,int workers,long long chunk,long long pos)
+        :_base(base),_worker(worker),_workers(workers),_chunk(chunk),_pos(pos){
+        if(workers<=0||worker<0||worker>=workers){
+            throw std::runtime_error("SeedScheduler: worker编号超出范围: "+std::to_string(worker)+"/"+std::to_string(workers));
+        }
+        if(chunk<=0||pos<0){
+            throw std::runtime_error("SeedScheduler: 块大小和位置必须为正数");
+        }
+    }
+    long long SeedScheduler::seed_at(long long pos) const{
+        long long block=pos/_chunk;
+        return _base+(block*_workers+_worker)*_chunk+pos%_chunk;
+    }
+    long long SeedScheduler::peek() const{
+        return seed_at(_pos);
+    }
+    long long SeedScheduler::next(){
+        return seed_at(_pos++);
+    }
+    long long SeedScheduler::remaining() const{
+        return _chunk-_pos%_chunk;
+    }
+    long long SeedScheduler::position() const{
+        return _pos;
+    }
+    int SeedScheduler::owner(long long seed) const{
+        if(seed<_base){
+            return -1;
+        }
+        return (int)(((seed-_base)/_chunk)%_workers);
+    }
+}
@@ -0,0 +1,340 @@
+#include "SharedLib.h"
+#include <stdexcept>
+#include <cstdio>
+#include <csignal>
+#include <cerrno>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+namespace process{
+    // 入口函数类型，即程序的main
+    using Entry=int(*)(int,char **);
+    // 写入全部数据，对端关闭时返回false
+    static bool write_all(int fd,const char *data,size_t len){
+        while(len>0){
+            ssize_t n=::write(fd,data,len);
+            if(n<0&&errno==EINTR){
+                continue;
+            }
+            if(n<=0){
+                return false;
+            }
+            data+=n;
+            len-=n;
+        }
+        return true;
+    }
+    // 读取一行，对端关闭时返回false
+    static bool read_line(int fd,string &line){
+        line.clear();
+        char c;
+        while(true){
+            ssize_t n=::read(fd,&c,1);
+            if(n<0&&errno==EINTR){
+                continue;
+            }
+            if(n!=1){
+                return false;
+            }
+            if(c=='\n'){
+                return true;
+            }
+            line+=c;
+        }
+    }
+    // 帧格式: 一行十进制字节数，随后是内容
+    static bool write_frame(int fd,std::string_view data){
+        string header=std::to_string(data.size())+"\n";
+        return write_all(fd,header.data(),header.size())&&write_all(fd,data.data(),data.size());
+    }
+    static bool read_frame(int fd,string &data){
+        string header;
+        if(!read_line(fd,header)){
+            return false;
+        }
+        data.resize(std::stoul(header));
+        size_t done=0;
+        while(done<data.size()){
+            ssize_t n=::read(fd,data.data()+done,data.size()-done);
+            if(n<0&&errno==EINTR){
+                continue;
+            }
+            if(n<=0){
+                return false;
+            }
+            done+=n;
+        }
+        return true;
+    }
+    // 在当前进程中载入共享库并查找main，只在子进程中调用
+    static Entry load_entry(const string &path,string &error){
+        void *handle=dlopen(path.c_str(),RTLD_NOW|RTLD_LOCAL);
+        if(handle==nullptr){
+            error="SharedLib: 无法载入共享库: "+path+" - "+dlerror();
+            return nullptr;
+        }
+        // 直接使用程序自身的main，返回值语义与独立运行时一致
+        Entry entry=reinterpret_cast<Entry>(dlsym(handle,"main"));
+        if(entry==nullptr){
+            error="SharedLib: 共享库中没有main: "+path;
+        }
+        return entry;
+    }
+    // 创建子进程前清空缓冲区，避免缓冲内容被子进程重复输出
+    static void flush_all(){
+        std::cout.flush();
+        std::cerr.flush();
+        fflush(nullptr);
+    }
+    // 关闭描述符并置为-1
+    static void close_fd(int &fd){
+        if(fd!=-1){
+            ::close(fd);
+        }
+        fd=-1;
+    }
+    // 等待进程结束，返回waitpid状态
+    static int reap(pid_t &pid){
+        int status=0;
+        while(waitpid(pid,&status,0)==-1&&errno==EINTR){}
+        pid=-1;
+        return status;
+    }
+    static Status to_status(int status){
+        if(WIFEXITED(status)){
+            return WEXITSTATUS(status)==0?STOP:ERROR;
+        }
+        return RE;
+    }
+
+    SharedLib::SharedLib(){}
+    SharedLib::SharedLib(const fs::path &file){
+        open(file);
+    }
+    // 启动载入进程
+    void SharedLib::open(const fs::path &file){
+        close();
+        // 路径中不含'/'时dlopen会搜索系统目录
+        _path=fs::absolute(file).string();
+        int request[2],reply[2];
+        open_pipes(request,reply);
+        flush_all();
+        pid_t pid=fork();
+        if(pid<0){
+            for(int fd:{ request[0],request[1],reply[0],reply[1] }){
+                ::close(fd);
+            }
+            throw std::runtime_error("SharedLib: 创建子进程失败");
+        }
+        if(pid==0){
+            ::close(request[1]);
+            ::close(reply[0]);
+            loader_loop(request[0],reply[1]);
+        }
+        ::close(request[0]);
+        ::close(reply[1]);
+        _loaderPid=pid;
+        _loaderIn=request[1];
+        _loaderOut=reply[0];
+        // 载入进程报告载入结果
+        string line;
+        if(!read_line(_loaderOut,line)||line!="OK"){
+            close();
+            throw std::runtime_error(line.empty()?"SharedLib: 载入进程异常退出: "+_path:line);
+        }
+    }
+    void SharedLib::close(){
+        stop_service();
+        if(_loaderPid>0){
+            // 关闭请求管道，载入进程读到EOF后退出
+            close_fd(_loaderIn);
+            close_fd(_loaderOut);
+            reap(_loaderPid);
+        }
+    }
+    bool SharedLib::is_open() const{
+        return _loaderPid>0;
+    }
+    void SharedLib::open_pipes(int request[2],int reply[2]){
+        if(pipe2(request,O_CLOEXEC)==-1){
+            throw std::runtime_error("SharedLib: 创建管道失败");
+        }
+        if(pipe2(reply,O_CLOEXEC)==-1){
+            ::close(request[0]);
+            ::close(request[1]);
+            throw std::runtime_error("SharedLib: 创建管道失败");
+        }
+    }
+    // 请求: 参数个数一行，随后每个参数、输出文件、工作目录各一帧；应答: waitpid状态一行
+    Status SharedLib::run(Args args,const fs::path &output,const fs::path &workdir){
+        if(!is_open()){
+            throw std::runtime_error("SharedLib: 共享库未载入");
+        }
+        string count=std::to_string(args.size())+"\n";
+        bool sent=write_all(_loaderIn,count.data(),count.size());
+        for(size_t i=0;sent&&i<args.size();i++){
+            sent=write_frame(_loaderIn,args[i]);
+        }
+        sent=sent&&write_frame(_loaderIn,output.string())&&write_frame(_loaderIn,workdir.string());
+        string line;
+        if(!sent||!read_line(_loaderOut,line)){
+            close();
+            throw std::runtime_error("SharedLib: 载入进程异常退出: "+_path);
+        }
+        _exit_code=std::stoi(line);
+        return to_status(_exit_code);
+    }
+    // 载入进程: 共享库只在子进程中载入，其静态析构不会在当前进程中执行
+    void SharedLib::loader_loop(int request,int reply){
+        signal(SIGPIPE,SIG_DFL);
+        // 不持有常驻进程的管道，否则常驻进程收不到EOF
+        close_fd(_request);
+        close_fd(_reply);
+        string error;
+        Entry entry=load_entry(_path,error);
+        if(entry==nullptr){
+            error+="\n";
+            write_all(reply,error.data(),error.size());
+            _exit(EXIT_FAILURE);
+        }
+        write_all(reply,"OK\n",3);
+        string line,output,workdir;
+        while(read_line(request,line)){
+            Args args;
+            size_t count=std::stoul(line);
+            for(size_t i=0;i<count;i++){
+                if(!read_frame(request,line)){
+                    _exit(EXIT_FAILURE);
+                }
+                args.add(line);
+            }
+            if(!read_frame(request,output)||!read_frame(request,workdir)){
+                _exit(EXIT_FAILURE);
+            }
+            // 每次运行都从载入时的全局状态开始
+            flush_all();
+            pid_t pid=fork();
+            if(pid==0){
+                ::close(request);
+                ::close(reply);
+                if(!workdir.empty()&&chdir(workdir.c_str())==-1){
+                    _exit(EXIT_FAILURE);
+                }
+                if(!output.empty()){
+                    int fd=::open(output.c_str(),O_WRONLY|O_CREAT|O_TRUNC,0644);
+                    if(fd==-1||dup2(fd,STDOUT_FILENO)==-1){
+                        _exit(EXIT_FAILURE);
+                    }
+                    ::close(fd);
+                }
+                int code=entry((int)args.size(),args.data());
+                // 不经过exit，避免执行父进程的析构和atexit
+                flush_all();
+                _exit(code);
+            }
+            int status=pid<0?W_EXITCODE(EXIT_FAILURE,0):reap(pid);
+            string answer=std::to_string(status)+"\n";
+            if(!write_all(reply,answer.data(),answer.size())){
+                break;
+            }
+        }
+        _exit(0);
+    }
+    // 请求: 一帧输入；应答: main的返回值一行
+    Status SharedLib::serve(Args args,std::string_view input){
+        if(!is_open()){
+            throw std::runtime_error("SharedLib: 共享库未载入");
+        }
+        if(_servicePid>0&&_served>=_serviceLimit){
+            stop_service();
+        }
+        if(_servicePid<=0){
+            start_service(args);
+        }
+        _served++;
+        string line;
+        if(write_frame(_request,input)&&read_line(_reply,line)){
+            int code=std::stoi(line);
+            // 与waitpid的正常退出状态保持一致
+            _exit_code=W_EXITCODE(code&0xff,0);
+            return code==0?STOP:ERROR;
+        }
+        // 子进程退出(如testlib的quitf调用exit)，回收并取其退出状态
+        close_fd(_request);
+        close_fd(_reply);
+        _exit_code=reap(_servicePid);
+        return to_status(_exit_code);
+    }
+    void SharedLib::start_service(Args &args){
+        int request[2],reply[2];
+        open_pipes(request,reply);
+        flush_all();
+        pid_t pid=fork();
+        if(pid<0){
+            for(int fd:{ request[0],request[1],reply[0],reply[1] }){
+                ::close(fd);
+            }
+            throw std::runtime_error("SharedLib: 创建子进程失败");
+        }
+        if(pid==0){
+            ::close(request[1]);
+            ::close(reply[0]);
+            service_loop(args,request[0],reply[1]);
+        }
+        ::close(request[0]);
+        ::close(reply[1]);
+        _servicePid=pid;
+        _request=request[1];
+        _reply=reply[0];
+        _served=0;
+    }
+    // 常驻进程: 载入共享库后循环读取输入，以内存流替换stdin调用main
+    void SharedLib::service_loop(Args &args,int request,int reply){
+        signal(SIGPIPE,SIG_DFL);
+        // 不持有载入进程的管道，否则载入进程收不到EOF
+        close_fd(_loaderIn);
+        close_fd(_loaderOut);
+        string error;
+        Entry entry=load_entry(_path,error);
+        if(entry==nullptr){
+            std::cerr<<error<<std::endl;
+            _exit(EXIT_FAILURE);
+        }
+        string buffer;
+        FILE *origin=stdin;
+        while(read_frame(request,buffer)){
+            // testlib的registerValidation从stdin读取
+            FILE *input=buffer.empty()?fopen("/dev/null","r"):fmemopen(buffer.data(),buffer.size(),"r");
+            if(input==nullptr){
+                _exit(EXIT_FAILURE);
+            }
+            stdin=input;
+            int code=entry((int)args.size(),args.data());
+            stdin=origin;
+            fclose(input);
+            flush_all();
+            string answer=std::to_string(code)+"\n";
+            if(!write_all(reply,answer.data(),answer.size())){
+                break;
+            }
+        }
+        _exit(0);
+    }
+    void SharedLib::stop_service(){
+        if(_servicePid<=0){
+            return;
+        }
+        // 关闭请求管道，子进程读到EOF后退出
+        close_fd(_request);
+        close_fd(_reply);
+        reap(_servicePid);
+    }
+    int SharedLib::get_exit_code() const{
+        return _exit_code;
+    }
+    SharedLib::~SharedLib(){
+        close();
+    }
+}
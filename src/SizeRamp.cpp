@@ -0,0 +1,54 @@
+#include "SizeRamp.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace acm{
+    SizeRamp::SizeRamp(){}
+    SizeRamp::SizeRamp(long long min,long long max,int buckets,int tests):_tests(tests){
+        if(min<=0||max<min||buckets<=0||tests<=0){
+            throw std::runtime_error("SizeRamp: 规模参数不合法");
+        }
+        // 几何分档，去掉取整后重复的规模
+        for(int i=0;i<buckets;i++){
+            double ratio=buckets==1?1:(double)i/(buckets-1);
+            long long size=std::llround(min*std::pow((double)max/min,ratio));
+            if(_sizes.empty()||size>_sizes.back()){
+                _sizes.push_back(size);
+            }
+        }
+        _count.assign(_sizes.size(),0);
+        _time.assign(_sizes.size(),0);
+    }
+    bool SizeRamp::enabled() const{
+        return !_sizes.empty();
+    }
+    long long SizeRamp::size() const{
+        return _sizes[_bucket];
+    }
+    int SizeRamp::bucket() const{
+        return _bucket;
+    }
+    int SizeRamp::remaining() const{
+        return _tests-_done;
+    }
+    void SizeRamp::record(double seconds){
+        _count[_bucket]++;
+        _time[_bucket]+=seconds;
+        if(++_done>=_tests){
+            _done=0;
+            _bucket=(_bucket+1)%_sizes.size();
+        }
+    }
+    size_t SizeRamp::buckets() const{
+        return _sizes.size();
+    }
+    long long SizeRamp::size_of(size_t i) const{
+        return _sizes[i];
+    }
+    int SizeRamp::count_of(size_t i) const{
+        return _count[i];
+    }
+    double SizeRamp::time_of(size_t i) const{
+        return _time[i];
+    }
+}
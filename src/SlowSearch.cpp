@@ -0,0 +1,83 @@
+#include "SlowSearch.h"
+#include <atomic>
+#include <thread>
+#include <cmath>
+#include <stdexcept>
+
+namespace acm{
+    SlowSearch::SlowSearch(Eval eval,int jobs,long long sizeMin,long long sizeMax,uint64_t seed)
+        :_eval(std::move(eval)),_jobs(jobs),_sizeMin(sizeMin),_sizeMax(sizeMax),_rng(seed){
+        if(jobs<=0){
+            throw std::runtime_error("SlowSearch: 线程数必须为正");
+        }
+        if(sizeMax<0||(sizeMax>0&&(sizeMin<=0||sizeMin>sizeMax))){
+            throw std::runtime_error("SlowSearch: 规模范围非法");
+        }
+    }
+    SlowSearch::Candidate SlowSearch::random_candidate(){
+        Candidate res;
+        res.seed=std::uniform_int_distribution<long long>(1,1000000000)(_rng);
+        if(_sizeMax>0){
+            // 通常规模越大越慢，从上半区间开始
+            res.size=std::uniform_int_distribution<long long>(std::max(_sizeMin,_sizeMax/2),_sizeMax)(_rng);
+        }
+        return res;
+    }
+    SlowSearch::Candidate SlowSearch::neighbour(){
+        Candidate res=random_candidate();
+        if(_sizeMax==0||std::bernoulli_distribution(0.5)(_rng)){
+            res.size=_best.size;
+            return res;
+        }
+        res.seed=_best.seed;
+        double factor=std::exp(std::uniform_real_distribution<double>(-_step,_step)(_rng));
+        long long size=std::llround(_best.size*factor);
+        if(size==_best.size){
+            size+=factor<1?-1:1;
+        }
+        res.size=std::min(std::max(size,_sizeMin),_sizeMax);
+        return res;
+    }
+    const SlowSearch::Candidate &SlowSearch::step(){
+        std::vector<Candidate> candidates(_jobs);
+        for(int i=0;i<_jobs;i++){
+            // 偶尔随机重启，避免困在局部最慢
+            bool restart=_best.cost<0||std::bernoulli_distribution(0.125)(_rng);
+            candidates[i]=restart?random_candidate():neighbour();
+        }
+        if(_best.cost<0&&_sizeMax>0){
+            candidates[0].size=_sizeMax;
+        }
+        std::atomic<int> next{ 0 };
+        auto work=[&](int worker){
+            for(int i=next++;i<_jobs;i=next++){
+                candidates[i].cost=_eval(candidates[i].seed,candidates[i].size,worker);
+            }
+        };
+        std::vector<std::thread> threads;
+        for(int k=1;k<_jobs;k++){
+            threads.emplace_back(work,k);
+        }
+        work(0);
+        for(auto &t:threads){
+            t.join();
+        }
+        _evaluations+=_jobs;
+        // 同样慢时取序号最小者，结果与线程调度无关
+        bool improved=false;
+        for(const auto &c:candidates){
+            if(c.cost>_best.cost){
+                _best=c;
+                improved=true;
+            }
+        }
+        _step=improved?std::min(1.0,_step*1.5):std::max(0.05,_step*0.7);
+        return _best;
+    }
+    const SlowSearch::Candidate &SlowSearch::best() const{
+        return _best;
+    }
+    long long SlowSearch::evaluations() const{
+        return _evaluations;
+    }
+}
@@ -0,0 +1,81 @@
+#include "Compare.h"
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <vector>
+
+// 朴素实现：istringstream 逐token比较
+static bool naive_compare(const string &a,const string &b){
+    std::istringstream sa(a),sb(b);
+    string x,y;
+    while(true){
+        bool ra=static_cast<bool>(sa>>x);
+        bool rb=static_cast<bool>(sb>>y);
+        if(ra!=rb) return false;
+        if(!ra) return true;
+        if(x!=y) return false;
+    }
+}
+
+// 生成约size字节的输出，模拟多组整数答案
+static string make_output(size_t size,unsigned seed,const string &sep){
+    std::mt19937 rng(seed);
+    std::ostringstream os;
+    size_t line=0;
+    while((size_t)os.tellp()<size){
+        os<<rng()%1000000000;
+        os<<((++line%16==0)?"\n":sep);
+    }
+    return os.str();
+}
+
+template<typename F>
+static double measure(F func,int rounds){
+    auto start=std::chrono::steady_clock::now();
+    for(int i=0;i<rounds;i++){
+        func();
+    }
+    auto end=std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end-start).count()/rounds;
+}
+
+int main(int argc,char **argv){
+    size_t size=(argc>1?std::stoul(argv[1]):64)*1024*1024;
+    int rounds=argc>2?std::stoi(argv[2]):5;
+    string a=make_output(size,1," ");
+    // 每个空格替换为两个空格，token完全相同，只测试空白差异的处理
+    string spaced;
+    spaced.reserve(a.size()*2);
+    for(char c:a){
+        spaced+=c;
+        if(c==' ') spaced+=' ';
+    }
+    std::vector<std::pair<string,string>> cases={
+        { "完全相同",a },
+        { "空白不同",spaced },
+        { "末尾不同",a.substr(0,a.size()-2)+"7\n" },
+    };
+    std::vector<acm::CompareKernel> kernels={ acm::Kernel_Scalar };
+    if(acm::best_kernel()>=acm::Kernel_SSE42) kernels.push_back(acm::Kernel_SSE42);
+    if(acm::best_kernel()>=acm::Kernel_AVX2) kernels.push_back(acm::Kernel_AVX2);
+
+    std::cout<<"数据大小: "<<a.size()/1024/1024<<"MB, 轮数: "<<rounds<<std::endl;
+    std::cout<<std::fixed<<std::setprecision(1);
+    for(auto &[name,b]:cases){
+        std::cout<<"== "<<name<<" =="<<std::endl;
+        bool expect=naive_compare(a,b);
+        double t=measure([&](){ naive_compare(a,b); },rounds);
+        std::cout<<"  istringstream: "<<a.size()/t/1e6<<" MB/s"<<std::endl;
+        for(auto kernel:kernels){
+            acm::CompareResult res;
+            t=measure([&](){ res=acm::compare_tokens(a,b,kernel); },rounds);
+            std::cout<<"  "<<acm::f(kernel)<<": "<<a.size()/t/1e6<<" MB/s";
+            if(res.same!=expect){
+                std::cout<<" (结果不一致!)";
+            }
+            std::cout<<std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include "test_framework.h"
+#include "AutoConfig.h"
+#include <thread>
+
+namespace {
+    fs::path config_file() {
+        fs::path dir = fs::temp_directory_path() / "acm_autoconfig_test";
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        return dir / "config.json";
+    }
+    acm::json read(const fs::path &file) {
+        std::ifstream in(file);
+        return acm::json::parse(in);
+    }
+}
+
+TestSuite create_autoconfig_tests() {
+    TestSuite suite("AutoConfig类");
+
+    suite.add_test("默认每次保存都写入", []() -> std::string {
+        fs::path file = config_file();
+        acm::AutoConfig config(file);
+        config["a"] = 1;
+        config.save();
+        assert_true(!config.pending(), "不合并时不应有推迟的保存");
+        assert_equal(read(file)["a"].get<int>(), 1, "保存的内容错误");
+        assert_true(!fs::exists(fs::path(file) += ".tmp"), "不应留下临时文件");
+        return "";
+    });
+
+    suite.add_test("内容不变时不写入", []() -> std::string {
+        fs::path file = config_file();
+        {
+            acm::AutoConfig config(file);
+            config["a"] = 1;
+            config.save();
+        }
+        acm::AutoConfig config(file);
+        auto before = fs::last_write_time(file);
+        // 修改时间的精度有限，先把文件时间调早
+        fs::last_write_time(file, before - std::chrono::hours(1));
+        config.save();
+        assert_true(fs::last_write_time(file) < before, "读取后未修改时不应重写文件");
+        config["a"] = 2;
+        config.save();
+        assert_equal(read(file)["a"].get<int>(), 2, "修改后应写入");
+        return "";
+    });
+
+    suite.add_test("合并保存与flush", []() -> std::string {
+        fs::path file = config_file();
+        {
+            acm::AutoConfig config(file);
+            config.set_debounce(0, 3);
+            for (int i = 1; i <= 2; i++) {
+                config["n"] = i;
+                config.save();
+            }
+            assert_true(config.pending(), "未达到次数时应推迟");
+            assert_equal(fs::file_size(file), (uintmax_t)0, "推迟的保存不应写入文件");
+            config["n"] = 3;
+            config.save();
+            assert_true(!config.pending(), "达到次数时应写入");
+            assert_equal(read(file)["n"].get<int>(), 3, "达到次数时写入的内容错误");
+
+            config.set_debounce(3600, 0);
+            config["n"] = 4;
+            config.save();
+            assert_equal(read(file)["n"].get<int>(), 3, "未到时间时不应写入");
+            config.flush();
+            assert_equal(read(file)["n"].get<int>(), 4, "flush应立即写入");
+            config["n"] = 5;
+            config.save();
+        }
+        assert_equal(read(file)["n"].get<int>(), 5, "析构时应写入推迟的保存");
+        return "";
+    });
+
+    suite.add_test("按时间间隔写入", []() -> std::string {
+        fs::path file = config_file();
+        acm::AutoConfig config(file);
+        config.set_debounce(0.05, 0);
+        config["t"] = 1;
+        config.save();
+        std::this_thread::sleep_for(std::chrono::milliseconds(80));
+        config["t"] = 2;
+        config.save();
+        assert_true(!config.pending(), "超过间隔时应写入");
+        assert_equal(read(file)["t"].get<int>(), 2, "按间隔写入的内容错误");
+        return "";
+    });
+
+    return suite;
+}
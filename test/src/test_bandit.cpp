@@ -0,0 +1,49 @@
+#include "test_framework.h"
+#include "Bandit.h"
+
+TestSuite create_bandit_tests() {
+    TestSuite suite("Bandit类");
+
+    suite.add_test("未运行的生成器优先", []() -> std::string {
+        acm::Bandit bandit(std::vector<acm::Bandit::Arm>(3), 1, 42);
+        assert_true(bandit.enabled(), "三个生成器应启用");
+        for (size_t i = 0; i < 3; i++) {
+            assert_equal(bandit.select(), i, "应依次尝试每个生成器");
+            bandit.record(i, 0.01);
+        }
+        assert_true(!acm::Bandit(std::vector<acm::Bandit::Arm>(1)).enabled(), "单个生成器不启用");
+        return "";
+    });
+
+    suite.add_test("偏向每秒错误数高的生成器", []() -> std::string {
+        // 生成器1每秒约发现20个错误，其余不发现错误
+        acm::Bandit bandit(std::vector<acm::Bandit::Arm>(3), 1, 7);
+        for (int i = 0; i < 3000; i++) {
+            size_t arm = bandit.select();
+            bandit.record(arm, 0.01);
+            if (arm == 1 && i % 5 == 0) {
+                bandit.bug(arm);
+            }
+        }
+        assert_true(bandit.arm(1).runs > 2000, "应把大部分运行分配给发现错误的生成器");
+        assert_true(bandit.arm(0).runs > 0 && bandit.arm(2).runs > 0, "其余生成器仍应被探索");
+        assert_true(bandit.arm(1).yield() > bandit.arm(0).yield(), "每秒错误数统计错误");
+        return "";
+    });
+
+    suite.add_test("耗时影响分配", []() -> std::string {
+        // 两个生成器每组发现错误的概率相同，生成器0每组耗时是生成器1的10倍
+        std::vector<acm::Bandit::Arm> arms(2);
+        arms[0] = {1000, 100, 100.0};
+        arms[1] = {1000, 100, 10.0};
+        acm::Bandit bandit(arms, 1, 3);
+        int fast = 0;
+        for (int i = 0; i < 1000; i++) {
+            fast += bandit.select() == 1;
+        }
+        assert_true(fast > 950, "应偏向每秒错误数更高的生成器");
+        return "";
+    });
+
+    return suite;
+}
@@ -0,0 +1,154 @@
+#include "test_framework.h"
+#include "Compare.h"
+#include <vector>
+
+TestSuite create_compare_tests() {
+    TestSuite suite("Compare比较");
+
+    // 所有可用内核都要测试
+    static std::vector<acm::CompareKernel> kernels = {acm::Kernel_Scalar};
+    if (acm::best_kernel() >= acm::Kernel_SSE42) kernels.push_back(acm::Kernel_SSE42);
+    if (acm::best_kernel() >= acm::Kernel_AVX2) kernels.push_back(acm::Kernel_AVX2);
+
+    suite.add_test("相同输出", []() -> std::string {
+        for (auto kernel : kernels) {
+            assert_true(acm::compare_tokens("1 2 3\n", "1 2 3\n", kernel).same, "完全相同应一致: " + acm::f(kernel));
+            assert_true(acm::compare_tokens("", "", kernel).same, "空输出应一致: " + acm::f(kernel));
+            assert_true(acm::compare_tokens("", " \n\t", kernel).same, "空白与空输出应一致: " + acm::f(kernel));
+        }
+        return "";
+    });
+
+    suite.add_test("忽略空白差异", []() -> std::string {
+        for (auto kernel : kernels) {
+            assert_true(acm::compare_tokens("1  2\r\n3", "1 2\n3\n", kernel).same, "空白长度不同应一致: " + acm::f(kernel));
+            assert_true(acm::compare_tokens("  12 34", "12\t34  \n\n", kernel).same, "首尾空白应忽略: " + acm::f(kernel));
+        }
+        return "";
+    });
+
+    suite.add_test("差异处理后的长空白和长token", []() -> std::string {
+        // 标量探测之后交给内核继续处理的部分
+        std::string spaces(100, ' ');
+        std::string token(100, '7');
+        for (auto kernel : kernels) {
+            assert_true(acm::compare_tokens("1 " + token + " 2", "1" + spaces + token + spaces + "2", kernel).same, "长空白应一致: " + acm::f(kernel));
+            std::string other = token;
+            other[60] = '8';
+            auto res = acm::compare_tokens("1 " + token, "1  " + other, kernel);
+            assert_true(!res.same && res.token == 1 && res.offsetA == 2 && res.offsetB == 3, "长token内的差异应定位到token起点: " + acm::f(kernel));
+        }
+        return "";
+    });
+
+    suite.add_test("定位不同token", []() -> std::string {
+        for (auto kernel : kernels) {
+            auto res = acm::compare_tokens("12 345 6", "12  346 6", kernel);
+            assert_true(!res.same, "应检测到不同: " + acm::f(kernel));
+            assert_equal(res.token, (size_t)1, "token序号错误");
+            assert_equal(res.offsetA, (size_t)3, "输出偏移错误");
+            assert_equal(res.offsetB, (size_t)4, "答案偏移错误");
+
+            res = acm::compare_tokens("12", "123", kernel);
+            assert_true(!res.same && res.token == 0 && res.offsetA == 0, "token前缀不应视为相同: " + acm::f(kernel));
+
+            res = acm::compare_tokens("12 3", "12", kernel);
+            assert_true(!res.same && res.token == 1 && res.offsetB == 2, "多余token应被检测: " + acm::f(kernel));
+        }
+        return "";
+    });
+
+    suite.add_test("长输出跨块比较", []() -> std::string {
+        std::string a, b;
+        for (int i = 0; i < 1000; i++) {
+            a += std::to_string(i * 7919) + " ";
+            b += std::to_string(i * 7919) + (i % 3 ? " " : "\n");
+        }
+        std::string c = b;
+        c[c.size() / 2 + 7] = '#';
+        for (auto kernel : kernels) {
+            assert_true(acm::compare_tokens(a, b, kernel).same, "长输出应一致: " + acm::f(kernel));
+            auto res = acm::compare_tokens(a, c, kernel);
+            auto ref = acm::compare_tokens(a, c, acm::Kernel_Scalar);
+            assert_true(!res.same, "长输出差异应被检测: " + acm::f(kernel));
+            assert_true(res.token == ref.token && res.offsetA == ref.offsetA, "各内核结果应一致: " + acm::f(kernel));
+        }
+        return "";
+    });
+
+    suite.add_test("浮点误差比较", []() -> std::string {
+        assert_true(acm::compare_numbers("0.3333333 1e5\n", "0.33333334 100000", 1e-6, 1e-6).same, "误差内应一致");
+        assert_true(acm::compare_numbers("1000000.5", "1000000", 1e-9, 1e-6).same, "相对误差内应一致");
+        assert_true(acm::compare_numbers("+2 nan", "2.000 nan", 1e-9, 1e-9).same, "正号与nan应正确处理");
+        auto res = acm::compare_numbers("1.5 2.5 YES", "1.5 2.6 YES", 1e-6, 1e-6);
+        assert_true(!res.same && res.token == 1 && res.offsetA == 4, "超出误差应定位到第二个token");
+        res = acm::compare_numbers("1.5 yes", "1.5 YES", 1e-6, 1e-6);
+        assert_true(!res.same && res.token == 1, "非数字token应逐字节比较");
+        res = acm::compare_numbers("1 2", "1 2 3", 1e-6, 1e-6);
+        assert_true(!res.same && res.token == 2 && res.offsetA == 3, "缺少token应被检测");
+        return "";
+    });
+
+    suite.add_test("流式比较", []() -> std::string {
+        // 分块到达，token跨块
+        acm::StreamCompare same;
+        same.feed(0, "12 3", 4);
+        same.feed(1, "1", 1);
+        same.feed(1, "2  34", 5);
+        assert_true(!same.done(), "数据未结束时不应得出结论");
+        same.feed(0, "4\n", 2);
+        same.close(0);
+        same.close(1);
+        assert_true(same.done() && same.result().same, "分块相同输出应一致");
+
+        // 出现差异即可得出结论，无需等待输出结束
+        acm::StreamCompare diff;
+        diff.feed(0, "1 2 3 ", 6);
+        diff.feed(1, "1 2 4 ", 6);
+        assert_true(diff.done() && !diff.result().same, "差异应被提前检测");
+        assert_true(diff.result().token == 2 && diff.result().offsetA == 4, "差异位置错误");
+
+        // 领先一侧的数据在另一侧到达前不能比较
+        acm::StreamCompare lag;
+        lag.feed(0, "1 2 3 4 ", 8);
+        assert_equal(lag.pending(0), (size_t)8, "另一侧没有数据时应全部等待比较");
+        lag.feed(1, "1 2 ", 4);
+        assert_true(lag.pending(0) < 8 && lag.pending(1) == 0, "另一侧到达后应消耗已比较的部分");
+
+        // 很长的token分多块到达，已比较的部分不重复比较
+        std::string token(1 << 20, '7');
+        for (int differ = 0; differ < 2; differ++) {
+            std::string other = token;
+            if (differ) {
+                other[other.size() - 5] = '8';
+            }
+            acm::StreamCompare big;
+            big.feed(0, "1 ", 2);
+            big.feed(1, "1  ", 3);
+            for (size_t pos = 0; pos < token.size(); pos += 65536) {
+                big.feed(0, token.data() + pos, 65536);
+                big.feed(1, other.data() + pos, 65536);
+            }
+            assert_true(!big.done(), "token未结束时不应得出结论");
+            big.feed(0, " 2\n", 3);
+            big.feed(1, " 2\n", 3);
+            big.close(0);
+            big.close(1);
+            assert_true(big.done() && big.result().same != (bool)differ, "长token分块比较结果错误");
+            if (differ) {
+                assert_true(big.result().token == 1 && big.result().offsetA == 2 && big.result().offsetB == 3, "长token的差异应定位到token起点");
+            }
+        }
+
+        // 浮点模式
+        acm::StreamCompare eps(1e-6, 1e-6);
+        eps.feed(0, "0.5000001 ", 10);
+        eps.feed(1, "0.5 ", 4);
+        eps.close(0);
+        eps.close(1);
+        assert_true(eps.done() && eps.result().same, "误差内应一致");
+        return "";
+    });
+
+    return suite;
+}
@@ -0,0 +1,83 @@
+#include "test_framework.h"
+#include "Corpus.h"
+#include <fstream>
+
+namespace {
+    fs::path corpus_dir() {
+        fs::path dir = fs::temp_directory_path() / "acm_corpus_test";
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        return dir;
+    }
+    size_t count_objects(const fs::path &dir) {
+        size_t count = 0;
+        for (const auto &entry : fs::recursive_directory_iterator(dir / "objects")) {
+            count += entry.is_regular_file();
+        }
+        return count;
+    }
+}
+
+TestSuite create_corpus_tests() {
+    TestSuite suite("Corpus类");
+
+    suite.add_test("压缩与解压", []() -> std::string {
+        std::string data;
+        for (int i = 0; i < 10000; i++) {
+            data += std::to_string(i % 100) + (i % 10 ? " " : "\n");
+        }
+        std::string packed = acm::Corpus::compress(data), back;
+        assert_true(packed.size() * 5 < data.size(), "重复的文本应被压缩");
+        assert_true(acm::Corpus::decompress(packed, back), "解压应成功");
+        assert_equal(back, data, "解压内容错误");
+        assert_true(acm::Corpus::decompress(acm::Corpus::compress(""), back) && back.empty(), "空内容应能往返");
+        assert_true(!acm::Corpus::decompress(packed.substr(0, packed.size() / 2), back), "截断的数据应解压失败");
+        return "";
+    });
+
+    suite.add_test("按内容去重", []() -> std::string {
+        fs::path dir = corpus_dir();
+        acm::Corpus corpus;
+        corpus.open(dir / "corpus");
+        std::string a = corpus.put("1 2 3\n");
+        std::string b = corpus.put("4 5 6\n");
+        assert_true(a != b, "不同内容的哈希应不同");
+        assert_equal(corpus.put("1 2 3\n"), a, "相同内容的哈希应相同");
+        assert_equal(corpus.size(), (size_t)2, "相同内容只应保存一份");
+        assert_equal(count_objects(dir / "corpus"), (size_t)2, "文件数错误");
+        assert_equal(corpus.puts(), 3LL, "存入次数错误");
+        assert_equal(corpus.shared(), 1LL, "重复次数错误");
+        assert_equal(corpus.raw_bytes(), (uint64_t)12, "原始大小错误");
+        std::string data;
+        assert_true(corpus.get(a, data) && data == "1 2 3\n", "读取内容错误");
+        assert_true(!corpus.get("0000000000000000", data), "不存在的内容不应读取成功");
+        return "";
+    });
+
+    suite.add_test("重新打开后保留", []() -> std::string {
+        fs::path dir = corpus_dir();
+        std::ofstream(dir / "data.in") << "7 8 9\n";
+        std::string hash;
+        {
+            acm::Corpus corpus;
+            corpus.open(dir / "corpus");
+            hash = corpus.put_file(dir / "data.in");
+            corpus.put("");
+        }
+        acm::Corpus corpus;
+        corpus.open(dir / "corpus");
+        assert_equal(corpus.size(), (size_t)2, "重新打开后内容数错误");
+        assert_true(corpus.contains(hash), "重新打开后应包含之前的内容");
+        assert_equal(corpus.put("7 8 9\n"), hash, "重新打开后仍应去重");
+        assert_equal(corpus.shared(), 1LL, "已存在的内容不应再次写入");
+        std::string data;
+        assert_true(corpus.get(hash, data) && data == "7 8 9\n", "读取内容错误");
+        // 损坏的文件应被发现
+        fs::path file = dir / "corpus" / "objects" / hash.substr(0, 2) / hash;
+        std::ofstream(file, std::ios::binary | std::ios::trunc) << "broken";
+        assert_true(!corpus.get(hash, data), "损坏的内容不应读取成功");
+        return "";
+    });
+
+    return suite;
+}
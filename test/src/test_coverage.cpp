@@ -0,0 +1,83 @@
+#include "test_framework.h"
+#include "Coverage.h"
+#include <fstream>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+TestSuite create_coverage_tests() {
+    TestSuite suite("Coverage覆盖");
+
+    suite.add_test("合并位图", []() -> std::string {
+        fs::create_directories("./test_coverage");
+        acm::CoverageMap map;
+        map.open("./test_coverage/map");
+        map.reset();
+        map.data()[10] = 1;
+        map.data()[20] = 2;
+        assert_equal(map.merge(), (size_t)2, "新的边数错误");
+        assert_equal(map.edges(), (size_t)2, "已见边数错误");
+        assert_equal(map.merge(), (size_t)0, "相同覆盖不应算新的");
+        // 次数进入新的档位也算新的覆盖
+        map.reset();
+        map.data()[10] = 9;
+        assert_equal(map.merge(), (size_t)1, "次数档位变化应算新的");
+        assert_equal(map.edges(), (size_t)2, "次数档位变化不增加边数");
+        fs::remove_all("./test_coverage");
+        return "";
+    });
+
+    suite.add_test("插桩程序写入位图", []() -> std::string {
+        fs::create_directories("./test_coverage");
+        {
+            std::ofstream file("./test_coverage/rt.cpp");
+            file << acm::CoverageMap::runtime();
+            std::ofstream prog("./test_coverage/prog.cpp");
+            prog << "#include <cstdio>\n"
+                    "int main() {\n"
+                    "    int x = 0;\n"
+                    "    if (scanf(\"%d\", &x) == 1 && x > 5) {\n"
+                    "        for (int i = 0; i < x; i++) printf(\"%d\\n\", i);\n"
+                    "    }\n"
+                    "    return 0;\n"
+                    "}\n";
+        }
+        assert_true(std::system("g++ -O2 -c ./test_coverage/rt.cpp -o ./test_coverage/rt.o && "
+                                "g++ -O2 -fsanitize-coverage=trace-pc ./test_coverage/prog.cpp ./test_coverage/rt.o "
+                                "-o ./test_coverage/prog") == 0, "插桩编译失败");
+        acm::CoverageMap map;
+        map.open("./test_coverage/map");
+        std::string run = "ACM_COV_FILE=./test_coverage/map ./test_coverage/prog > /dev/null < ";
+        std::ofstream("./test_coverage/small.in") << "1\n";
+        std::ofstream("./test_coverage/big.in") << "100\n";
+        map.reset();
+        assert_true(std::system((run + "./test_coverage/small.in").c_str()) == 0, "运行失败");
+        size_t first = map.merge();
+        assert_true(first > 0, "应记录覆盖");
+        map.reset();
+        assert_true(std::system((run + "./test_coverage/small.in").c_str()) == 0, "运行失败");
+        assert_equal(map.merge(), (size_t)0, "相同输入不应有新的覆盖");
+        map.reset();
+        assert_true(std::system((run + "./test_coverage/big.in").c_str()) == 0, "运行失败");
+        assert_true(map.merge() > 0, "新的分支应有新的覆盖");
+        fs::remove_all("./test_coverage");
+        return "";
+    });
+
+    suite.add_test("变异", []() -> std::string {
+        std::mt19937_64 rng(1);
+        std::string input = "3\n10 20\n30 40\n50 60\n";
+        int changed = 0;
+        for (int i = 0; i < 100; i++) {
+            std::string res = acm::mutate(input, rng);
+            assert_true(!res.empty(), "变异结果不应为空");
+            changed += res != input;
+        }
+        assert_true(changed > 50, "大部分变异应改变输入");
+        std::mt19937_64 a(7), b(7);
+        assert_equal(acm::mutate(input, a), acm::mutate(input, b), "相同种子的变异应相同");
+        return "";
+    });
+
+    return suite;
+}
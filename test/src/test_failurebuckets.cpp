@@ -0,0 +1,52 @@
+#include "test_framework.h"
+#include "FailureBuckets.h"
+#include <sys/wait.h>
+
+TestSuite create_failurebuckets_tests() {
+    TestSuite suite("FailureBuckets分桶");
+
+    suite.add_test("token类型与位置", []() -> std::string {
+        using acm::FailureBuckets;
+        assert_equal(FailureBuckets::token_class(""), std::string("缺失"), "空token应为缺失");
+        assert_equal(FailureBuckets::token_class("-12"), std::string("负数"), "负数识别错误");
+        assert_equal(FailureBuckets::token_class("000"), std::string("零"), "零识别错误");
+        assert_equal(FailureBuckets::token_class("+7"), std::string("正数"), "正数识别错误");
+        assert_equal(FailureBuckets::token_class("1.5e-3"), std::string("小数"), "小数识别错误");
+        assert_equal(FailureBuckets::token_class("YES"), std::string("字符串"), "字符串识别错误");
+        assert_equal(FailureBuckets::token_class("-"), std::string("字符串"), "单独的符号应为字符串");
+        assert_equal(FailureBuckets::position_class(0), std::string("#0"), "位置分类错误");
+        assert_equal(FailureBuckets::position_class(5), std::string("#4-7"), "位置分类错误");
+        return "";
+    });
+
+    suite.add_test("失败特征", []() -> std::string {
+        using acm::FailureBuckets;
+        auto cmp = acm::compare_tokens("1 2 -3\n", "1 2 3\n");
+        assert_equal(FailureBuckets::signature(acm::WrongAnswer, 0, cmp, "1 2 -3\n", "1 2 3\n"),
+            std::string("WrongAnswer #2-3 负数/正数"), "WA特征错误");
+        cmp = acm::compare_tokens("1\n", "1 2\n");
+        assert_equal(FailureBuckets::signature(acm::WrongAnswer, 0, cmp, "1\n", "1 2\n"),
+            std::string("WrongAnswer #1 缺失/正数"), "缺少输出的特征错误");
+        assert_equal(FailureBuckets::signature(acm::RuntimeError, SIGSEGV, acm::CompareResult(), "", ""),
+            std::string("RuntimeError 信号11"), "RE特征应包含信号");
+        assert_equal(FailureBuckets::signature(acm::TimeLimitEXceeded, SIGKILL, acm::CompareResult(), "", ""),
+            std::string("TimeLimitEXceeded"), "TLE特征错误");
+        return "";
+    });
+
+    suite.add_test("每桶保留的样例数", []() -> std::string {
+        acm::FailureBuckets buckets(2, 2);
+        assert_true(buckets.add("A", "data1"), "第一个样例应保留");
+        assert_true(buckets.add("A", "data2"), "第二个样例应保留");
+        assert_true(!buckets.add("A", "data3"), "超过样例数不应保留");
+        assert_true(buckets.add("B", "data4"), "新的桶应保留样例");
+        assert_true(!buckets.add("C", "data5"), "超过桶数上限不应保留");
+        assert_equal(buckets.buckets().at("A").count, 3LL, "失败次数错误");
+        assert_equal(buckets.buckets().size(), (size_t)2, "桶数错误");
+        assert_equal(buckets.total(), 5LL, "总失败次数错误");
+        assert_equal(buckets.overflow(), 1LL, "溢出次数错误");
+        return "";
+    });
+
+    return suite;
+}
@@ -0,0 +1,81 @@
+#include "test_framework.h"
+#include "GenBatch.h"
+#include <cmath>
+
+TestSuite create_genbatch_tests() {
+    TestSuite suite("批量生成");
+
+    suite.add_test("调节批量大小", []() -> std::string {
+        acm::GenBatch batch;
+        assert_equal(batch.count(0, 100), 1, "自动调节时先测1组");
+        assert_true(!batch.tune(1, 0.5625), "只测了1组时不应完成调节");
+        assert_equal(batch.count(0, 100), 8, "第二批应测8组");
+        // 启动开销0.5秒，单组0.0625秒: 1组耗时0.5625，8组耗时0.5+8*0.0625=1
+        assert_true(batch.tune(8, 1.0), "测完8组应完成调节");
+        assert_true(batch.tuned(), "应记录调节完成");
+        assert_true(std::abs(batch.per() - 0.0625) < 1e-9, "单组耗时估计错误");
+        assert_true(std::abs(batch.overhead() - 0.5) < 1e-9, "启动开销估计错误");
+        // ceil(19*0.5/0.0625)=152
+        assert_equal(batch.count(0, 1000), 152, "批量应使启动开销占比不超过5%");
+        // 调节完成后不再改变
+        assert_true(!batch.tune(152, 100.0), "调节完成后不应再调节");
+        assert_equal(batch.count(0, 1000), 152, "调节完成后批量不应改变");
+        return "";
+    });
+
+    suite.add_test("批量大小限制在1到1024", []() -> std::string {
+        // 启动开销远大于单组耗时
+        acm::GenBatch large;
+        large.tune(1, 1.0);
+        large.tune(8, 1.0);
+        assert_equal(large.count(0, 100000), 1024, "批量不应超过1024");
+        // 没有启动开销
+        acm::GenBatch small;
+        small.tune(1, 0.01);
+        small.tune(8, 0.08);
+        assert_equal(small.count(0, 100000), 1, "批量不应小于1");
+        // 8组比1组更快时单组耗时取下限，不出现除零或负数
+        acm::GenBatch faster;
+        faster.tune(1, 0.5);
+        faster.tune(8, 0.1);
+        assert_equal(faster.count(0, 100000), 1024, "单组耗时非正时应取最大批量");
+        return "";
+    });
+
+    suite.add_test("固定批量", []() -> std::string {
+        acm::GenBatch batch;
+        assert_equal(batch.count(16, 100), 16, "固定批量应直接使用");
+        assert_equal(batch.count(16, 5), 5, "固定批量也不应跨出种子块");
+        return "";
+    });
+
+    suite.add_test("跨种子块的队列", []() -> std::string {
+        acm::GenBatch batch;
+        assert_true(!batch.ready(10, 0), "空队列需要生成");
+        // 种子块10~12只剩3个种子，批量8被限制为3
+        int count = batch.count(8, 3);
+        assert_equal(count, 3, "一批不应跨出种子块");
+        batch.fill(10, count, 0);
+        for (long long seed = 10; seed < 13; seed++) {
+            assert_true(batch.ready(seed, 0), "同一批中的种子应直接取出");
+            batch.pop();
+        }
+        assert_equal(batch.pending(), (size_t)0, "取完一批后队列应为空");
+        // 下一个种子块从100开始，需要重新生成
+        assert_true(!batch.ready(100, 0), "新种子块需要重新生成");
+        batch.fill(100, batch.count(8, 50), 0);
+        assert_equal(batch.pending(), (size_t)8, "新一批应有8组");
+        batch.pop();
+        // 种子块提前结束，跳到另一个块: 旧批剩余的种子不能使用
+        assert_true(!batch.ready(200, 0), "队首不是请求的种子时需要重新生成");
+        batch.fill(200, 2, 0);
+        assert_equal(batch.pending(), (size_t)2, "重新生成时应丢弃上一批剩余的种子");
+        // 规模变化时同一种子也需要重新生成
+        assert_true(!batch.ready(200, 50), "规模不同时需要重新生成");
+        batch.clear();
+        assert_true(!batch.ready(200, 0), "清空后需要重新生成");
+        return "";
+    });
+
+    return suite;
+}
@@ -0,0 +1,73 @@
+#include "test_framework.h"
+#include "Hash.h"
+
+TestSuite create_hash_tests() {
+    TestSuite suite("Hash哈希");
+
+    suite.add_test("XXH64标准值", []() -> std::string {
+        assert_equal(acm::hex64(acm::hash64("")), std::string("ef46db3751d8e999"), "空串哈希错误");
+        assert_equal(acm::hex64(acm::hash64("abc")), std::string("44bc2cf5ad770999"), "abc哈希错误");
+        return "";
+    });
+
+    suite.add_test("内容相同哈希相同", []() -> std::string {
+        // 覆盖32字节块、8字节、4字节和单字节的各个分支
+        std::string a;
+        for (int i = 0; i < 1000; i++) {
+            a += std::to_string(i * 31) + (i % 7 ? " " : "\n");
+            std::string b = a;
+            assert_equal(acm::hash64(a), acm::hash64(b), "相同内容哈希应相同");
+            b.back() ^= 1;
+            assert_true(acm::hash64(a) != acm::hash64(b), "不同内容哈希应不同");
+        }
+        assert_true(acm::hash64("abc", 1) != acm::hash64("abc"), "种子应影响哈希");
+        return "";
+    });
+
+    suite.add_test("去重集合", []() -> std::string {
+        acm::SeenSet seen(100);
+        for (uint64_t i = 0; i < 100; i++) {
+            assert_true(seen.insert(acm::hash64(&i, sizeof(i))), "新元素应插入成功");
+        }
+        assert_true(!seen.is_bloom(), "未超过上限时应为精确集合");
+        uint64_t x = 5;
+        assert_true(!seen.insert(acm::hash64(&x, sizeof(x))), "重复元素应被检测");
+
+        // 超过上限转为布隆过滤器，已有元素仍能检测
+        for (uint64_t i = 100; i < 1000; i++) {
+            seen.insert(acm::hash64(&i, sizeof(i)));
+        }
+        assert_true(seen.is_bloom(), "超过上限应转为布隆过滤器");
+        int missed = 0;
+        for (uint64_t i = 0; i < 1000; i++) {
+            missed += seen.insert(acm::hash64(&i, sizeof(i)));
+        }
+        assert_equal(missed, 0, "布隆过滤器不应漏判已有元素");
+        return "";
+    });
+
+    suite.add_test("远超上限时误判率不增长", []() -> std::string {
+        acm::SeenSet seen(1000);
+        // 插入上限的64倍
+        int rejected = 0;
+        for (uint64_t i = 0; i < 64000; i++) {
+            rejected += !seen.insert(acm::hash64(&i, sizeof(i)));
+        }
+        assert_true(seen.is_bloom(), "超过上限应转为布隆过滤器");
+        assert_true(rejected < 320, "插入过程中误判过多: " + std::to_string(rejected));
+        int missed = 0;
+        for (uint64_t i = 0; i < 64000; i++) {
+            missed += seen.insert(acm::hash64(&i, sizeof(i)));
+        }
+        assert_equal(missed, 0, "扩展后不应漏判已有元素");
+        // 新元素的误判率
+        int falsePositive = 0;
+        for (uint64_t i = 1000000; i < 1100000; i++) {
+            falsePositive += !seen.insert(acm::hash64(&i, sizeof(i)));
+        }
+        assert_true(falsePositive < 1000, "误判率应低于1%: " + std::to_string(falsePositive));
+        return "";
+    });
+
+    return suite;
+}
@@ -0,0 +1,136 @@
+#include "test_framework.h"
+#include "JsonlStore.h"
+#include <fstream>
+
+namespace {
+    fs::path store_file() {
+        fs::path dir = fs::temp_directory_path() / "acm_jsonlstore_test";
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        return dir / "data.jsonl";
+    }
+}
+
+TestSuite create_jsonlstore_tests() {
+    TestSuite suite("JsonlStore类");
+
+    suite.add_test("追加与读取", []() -> std::string {
+        fs::path file = store_file();
+        acm::JsonlStore store;
+        store.open(file);
+        assert_true(store.is_open() && store.empty(), "新文件应为空");
+        assert_equal(store.append({ { "in", "1 2\n" }, { "out", "3\n" } }), (size_t)0, "第一条记录的序号错误");
+        store.append({ { "in", "4 5\n" }, { "out", "9\n" } });
+        assert_equal(store.size(), (size_t)2, "记录数错误");
+        assert_equal(store.at(0)["out"].get<std::string>(), std::string("3\n"), "读取的记录错误");
+        assert_equal(store.back()["in"].get<std::string>(), std::string("4 5\n"), "最后一条记录错误");
+        // 每条记录一行
+        std::ifstream in(file);
+        std::string line;
+        int lines = 0;
+        while (std::getline(in, line)) {
+            lines++;
+        }
+        assert_equal(lines, 2, "每条记录应只占一行");
+        return "";
+    });
+
+    suite.add_test("替换记录并重新打开", []() -> std::string {
+        fs::path file = store_file();
+        {
+            acm::JsonlStore store;
+            store.open(file);
+            store.append({ { "in", "a" }, { "failed_at", 1 } });
+            store.append({ { "in", "b" }, { "failed_at", 2 } });
+            store.replace(0, { { "in", "a" }, { "failed_at", 3 } });
+            assert_equal(store.at(0)["failed_at"].get<int>(), 3, "替换后应读取新记录");
+            assert_true(!store.at(0).contains("_replaces"), "读取的记录不应包含替换标记");
+        }
+        acm::JsonlStore store;
+        store.open(file);
+        assert_equal(store.size(), (size_t)2, "替换不应增加记录数");
+        std::vector<int> times;
+        store.for_each([&](size_t, const acm::json &record) {
+            times.push_back(record["failed_at"].get<int>());
+        });
+        assert_true(times == std::vector<int>({ 3, 2 }), "重新打开后应以最后一行为准");
+        return "";
+    });
+
+    suite.add_test("替换键排在_replaces之前的记录", []() -> std::string {
+        fs::path file = store_file();
+        {
+            acm::JsonlStore store;
+            store.open(file);
+            store.append({ { "In", "a" }, { "0", 1 } });
+            store.append({ { "In", "b" }, { "0", 2 } });
+            store.replace(1, { { "In", "c" }, { "0", 3 } });
+        }
+        acm::JsonlStore store;
+        store.open(file);
+        assert_equal(store.size(), (size_t)2, "大写和数字键的替换不应成为新记录");
+        assert_equal(store.at(1)["In"].get<std::string>(), std::string("c"), "重新打开后应读取替换的记录");
+        assert_true(!store.at(1).contains("_replaces") && !store.at(1).contains("record"), "读取的记录不应包含替换的外层");
+        bool rejected = false;
+        try {
+            store.append({ { "_replaces", 0 } });
+        }
+        catch (const std::invalid_argument &) {
+            rejected = true;
+        }
+        assert_true(rejected, "包含_replaces字段的记录应被拒绝");
+        return "";
+    });
+
+    suite.add_test("只更新部分字段", []() -> std::string {
+        fs::path file = store_file();
+        std::string payload(4096, 'x');
+        {
+            acm::JsonlStore store;
+            store.open(file);
+            store.append({ { "in", payload }, { "failed_at", 1 } });
+            store.append({ { "in", "b" }, { "failed_at", 2 } });
+        }
+        uintmax_t before = fs::file_size(file);
+        {
+            acm::JsonlStore store;
+            store.open(file);
+            store.update(0, { { "failed_at", 5 } });
+            store.update(0, { { "failed_at", 6 } });
+            assert_equal(store.at(0)["failed_at"].get<int>(), 6, "应以最后一次更新为准");
+        }
+        assert_true(fs::file_size(file) - before < 100, "更新只应写入修改的字段");
+        acm::JsonlStore store;
+        store.open(file);
+        assert_equal(store.size(), (size_t)2, "更新不应增加记录数");
+        assert_equal(store.at(0)["in"].get<std::string>(), payload, "更新不应改变其他字段");
+        assert_equal(store.at(0)["failed_at"].get<int>(), 6, "重新打开后应合并更新");
+        assert_true(!store.at(0).contains("_updates"), "读取的记录不应包含更新标记");
+        // 替换之后之前的更新不再生效
+        store.replace(0, { { "in", "a" } });
+        store.update(1, { { "failed_at", 7 } });
+        acm::JsonlStore reopened;
+        reopened.open(file);
+        assert_true(!reopened.at(0).contains("failed_at"), "替换应丢弃之前的更新");
+        assert_equal(reopened.at(1)["failed_at"].get<int>(), 7, "其他记录的更新错误");
+        return "";
+    });
+
+    suite.add_test("截掉写入中断的最后一行", []() -> std::string {
+        fs::path file = store_file();
+        {
+            acm::JsonlStore store;
+            store.open(file);
+            store.append({ { "in", "x" } });
+        }
+        std::ofstream(file, std::ios::app) << "{\"in\":\"y";
+        acm::JsonlStore store;
+        store.open(file);
+        assert_equal(store.size(), (size_t)1, "不完整的行不应计入");
+        store.append({ { "in", "z" } });
+        assert_equal(store.at(1)["in"].get<std::string>(), std::string("z"), "截断后追加的记录错误");
+        return "";
+    });
+
+    return suite;
+}
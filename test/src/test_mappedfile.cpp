@@ -0,0 +1,50 @@
+#include "test_framework.h"
+#include "MappedFile.h"
+#include <fstream>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+TestSuite create_mappedfile_tests() {
+    TestSuite suite("MappedFile类");
+
+    suite.add_test("映射文件内容", []() -> std::string {
+        fs::create_directories("./test_mapped");
+        std::string content = "1 2 3\nhello world\n";
+        {
+            std::ofstream file("./test_mapped/data.in");
+            file << content;
+        }
+        acm::MappedFile mapped("./test_mapped/data.in");
+        assert_equal(mapped.size(), content.size(), "映射大小错误");
+        assert_equal(std::string(mapped.view()), content, "映射内容错误");
+
+        // 移动后原对象为空
+        acm::MappedFile moved(std::move(mapped));
+        assert_true(mapped.empty() && mapped.data() == nullptr, "移动后原对象应为空");
+        assert_equal(std::string(moved.view()), content, "移动后内容错误");
+
+        fs::remove_all("./test_mapped");
+        return "";
+    });
+
+    suite.add_test("空文件与不存在文件", []() -> std::string {
+        fs::create_directories("./test_mapped");
+        { std::ofstream file("./test_mapped/empty.in"); }
+        acm::MappedFile mapped("./test_mapped/empty.in");
+        assert_true(mapped.empty() && mapped.view().empty(), "空文件应映射为空");
+
+        bool thrown = false;
+        try {
+            acm::MappedFile missing("./test_mapped/missing.in");
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert_true(thrown, "不存在的文件应抛出异常");
+
+        fs::remove_all("./test_mapped");
+        return "";
+    });
+
+    return suite;
+}
@@ -0,0 +1,67 @@
+#include "test_framework.h"
+#include "Minimizer.h"
+
+TestSuite create_minimizer_tests() {
+    TestSuite suite("Minimizer最小化");
+
+    suite.add_test("按行最小化", []() -> std::string {
+        // 同时包含"L7"和"L13"两行时失败
+        auto test = [](const std::string &input, int) {
+            return input.find("L7\n") != std::string::npos && input.find("L13\n") != std::string::npos;
+        };
+        std::string input;
+        for (int i = 0; i < 40; i++) {
+            input += "L" + std::to_string(i) + "\n";
+        }
+        acm::Minimizer minimizer(test, 1);
+        assert_equal(minimizer.minimize(input, acm::Granularity_Line), std::string("L7\nL13\n"), "最小化结果错误");
+        assert_true(minimizer.tests() > 0, "应记录测试次数");
+        return "";
+    });
+
+    suite.add_test("按token最小化", []() -> std::string {
+        auto test = [](const std::string &input, int) {
+            return input.find("x") != std::string::npos;
+        };
+        acm::Minimizer minimizer(test, 2);
+        assert_equal(minimizer.minimize("  a b\nc x d\n", acm::Granularity_Token), std::string("x "), "最小化结果错误");
+        return "";
+    });
+
+    suite.add_test("并行结果与单线程一致", []() -> std::string {
+        auto test = [](const std::string &input, int) {
+            int count = 0;
+            for (char c : input) {
+                count += c == '#';
+            }
+            return count >= 3;
+        };
+        std::string input;
+        for (int i = 0; i < 200; i++) {
+            input += i % 17 == 0 ? "# " : ". ";
+        }
+        acm::Minimizer serial(test, 1);
+        acm::Minimizer parallel(test, 4);
+        std::string expect = serial.minimize(input, acm::Granularity_Token);
+        assert_equal(parallel.minimize(input, acm::Granularity_Token), expect, "并行结果应与单线程一致");
+        assert_equal(expect, std::string("# # # "), "最小化结果错误");
+        return "";
+    });
+
+    suite.add_test("测试次数上限", []() -> std::string {
+        auto test = [](const std::string &input, int) {
+            return input.find("5\n") != std::string::npos;
+        };
+        std::string input;
+        for (int i = 0; i < 1000; i++) {
+            input += std::to_string(i) + "\n";
+        }
+        acm::Minimizer minimizer(test, 2, 10);
+        std::string res = minimizer.minimize(input, acm::Granularity_Line);
+        assert_true(minimizer.tests() <= 10, "测试次数不应超过上限");
+        assert_true(res.find("5\n") != std::string::npos && res.size() < input.size(), "结果应仍然失败且变小");
+        return "";
+    });
+
+    return suite;
+}
@@ -0,0 +1,85 @@
+#include "test_framework.h"
+#include "OutputCache.h"
+#include <fstream>
+#include <sstream>
+
+namespace {
+    fs::path cache_dir() {
+        fs::path dir = fs::temp_directory_path() / "acm_outputcache_test";
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        return dir;
+    }
+    void write(const fs::path &file, const std::string &data) {
+        std::ofstream(file, std::ios::binary) << data;
+    }
+    std::string read(const fs::path &file) {
+        std::ifstream in(file, std::ios::binary);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        return ss.str();
+    }
+}
+
+TestSuite create_outputcache_tests() {
+    TestSuite suite("OutputCache类");
+
+    suite.add_test("命中与未命中", []() -> std::string {
+        fs::path dir = cache_dir();
+        acm::OutputCache cache;
+        cache.open(dir / "cache", 1 << 20);
+        assert_true(cache.enabled(), "上限为正时应启用");
+        assert_true(!cache.get(1, dir / "out"), "空缓存不应命中");
+        write(dir / "ans", "42\n");
+        cache.put(1, dir / "ans");
+        assert_true(cache.get(1, dir / "out"), "保存后应命中");
+        assert_equal(read(dir / "out"), std::string("42\n"), "命中的输出内容错误");
+        assert_equal(cache.hits(), 1LL, "命中次数错误");
+        assert_equal(cache.misses(), 1LL, "未命中次数错误");
+        acm::OutputCache off;
+        off.open(dir / "off", 0);
+        assert_true(!off.enabled(), "上限为0时不应启用");
+        return "";
+    });
+
+    suite.add_test("重新打开后仍然命中", []() -> std::string {
+        fs::path dir = cache_dir();
+        write(dir / "ans", "1 2 3\n");
+        {
+            acm::OutputCache cache;
+            cache.open(dir / "cache", 1 << 20);
+            cache.put(0xabcdefULL, dir / "ans");
+        }
+        // 不完整的写入应被忽略
+        write(dir / "cache" / "0000000000000007.tmp", "x");
+        acm::OutputCache cache;
+        cache.open(dir / "cache", 1 << 20);
+        assert_equal(cache.size(), (size_t)1, "应只读取已完成的输出");
+        assert_true(cache.get(0xabcdefULL, dir / "out"), "跨会话应命中");
+        assert_equal(read(dir / "out"), std::string("1 2 3\n"), "命中的输出内容错误");
+        return "";
+    });
+
+    suite.add_test("超过上限时淘汰最久未使用的输出", []() -> std::string {
+        fs::path dir = cache_dir();
+        write(dir / "ans", std::string(100, 'a'));
+        acm::OutputCache cache;
+        cache.open(dir / "cache", 350);
+        cache.put(1, dir / "ans");
+        cache.put(2, dir / "ans");
+        cache.put(3, dir / "ans");
+        // 使用1后，2成为最久未使用的输出
+        assert_true(cache.get(1, dir / "out"), "应命中1");
+        cache.put(4, dir / "ans");
+        assert_true(cache.bytes() <= 350, "总大小不应超过上限");
+        assert_true(!cache.get(2, dir / "out"), "最久未使用的输出应被淘汰");
+        assert_true(cache.get(1, dir / "out") && cache.get(4, dir / "out"), "最近使用的输出应保留");
+        assert_true(cache.evictions() >= 1, "淘汰次数错误");
+        write(dir / "big", std::string(1000, 'b'));
+        cache.put(5, dir / "big");
+        assert_true(!cache.get(5, dir / "out"), "超过上限的输出不应保存");
+        return "";
+    });
+
+    return suite;
+}
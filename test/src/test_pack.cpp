@@ -0,0 +1,41 @@
+#include "test_framework.h"
+#include "Pack.h"
+#include <algorithm>
+
+TestSuite create_pack_tests() {
+    TestSuite suite("打包定位");
+
+    suite.add_test("按行号定位子数据", []() -> std::string {
+        std::vector<long long> cases = {2, 3, 1};
+        // 每个子测试1行: 第3行属于第二组数据
+        auto order = acm::pack_order(cases, 3, 1);
+        assert_true(order == std::vector<size_t>({1, 0, 2}), "定位到的数据应排在最前，其余按原顺序");
+        // 每个子测试2行: 第10行属于第三组数据
+        order = acm::pack_order(cases, 10, 2);
+        assert_true(order == std::vector<size_t>({2, 0, 1}), "多行子测试定位错误");
+        return "";
+    });
+
+    suite.add_test("无法定位时按原顺序", []() -> std::string {
+        std::vector<long long> cases = {2, 3, 1};
+        assert_true(acm::pack_order(cases, -1, 1) == std::vector<size_t>({0, 1, 2}), "未知行号应按原顺序");
+        // 行号超出所有子测试
+        assert_true(acm::pack_order(cases, 100, 1) == std::vector<size_t>({0, 1, 2}), "超出范围应按原顺序");
+        return "";
+    });
+
+    suite.add_test("pack_lines错误时仍包含所有数据", []() -> std::string {
+        // 实际每个子测试输出1行，pack_lines误设为2: 第7行(第三组数据)被定位到第二组数据
+        std::vector<long long> cases = {3, 3, 3, 3};
+        auto order = acm::pack_order(cases, 7, 2);
+        assert_equal(order.size(), cases.size(), "定位错误时也应重跑每一组数据");
+        assert_equal(order[0], (size_t)1, "应先运行按行号定位到的数据");
+        assert_true(std::find(order.begin(), order.end(), (size_t)2) != order.end(), "真正失败的数据应被重跑");
+        std::vector<size_t> sorted = order;
+        std::sort(sorted.begin(), sorted.end());
+        assert_true(sorted == std::vector<size_t>({0, 1, 2, 3}), "每组数据应恰好出现一次");
+        return "";
+    });
+
+    return suite;
+}
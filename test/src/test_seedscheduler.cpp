@@ -0,0 +1,59 @@
+#include "test_framework.h"
+#include "SeedScheduler.h"
+#include <set>
+
+TestSuite create_seedscheduler_tests() {
+    TestSuite suite("SeedScheduler类");
+
+    suite.add_test("单worker连续分配", []() -> std::string {
+        // 默认参数与原先按数据编号作为种子一致
+        acm::SeedScheduler seeds(1, 0, 1, 1024);
+        for (long long i = 1; i <= 3000; i++) {
+            assert_equal(seeds.next(), i, "种子应连续");
+        }
+        assert_equal(seeds.position(), 3000LL, "位置错误");
+        return "";
+    });
+
+    suite.add_test("多worker互不相交", []() -> std::string {
+        std::set<long long> all;
+        for (int w = 0; w < 3; w++) {
+            acm::SeedScheduler seeds(100, w, 3, 4);
+            for (int i = 0; i < 20; i++) {
+                long long seed = seeds.next();
+                assert_true(all.insert(seed).second, "种子重复: " + std::to_string(seed));
+                assert_equal(seeds.owner(seed), w, "种子归属错误");
+            }
+        }
+        // 3个worker各取20个，恰好覆盖前60个种子
+        assert_equal(*all.begin(), 100LL, "最小种子错误");
+        assert_equal(*all.rbegin(), 159LL, "最大种子错误");
+        return "";
+    });
+
+    suite.add_test("块内剩余与恢复", []() -> std::string {
+        acm::SeedScheduler seeds(0, 1, 2, 8);
+        assert_equal(seeds.peek(), 8LL, "第一块起点错误");
+        assert_equal(seeds.remaining(), 8LL, "剩余数错误");
+        for (int i = 0; i < 7; i++) seeds.next();
+        assert_equal(seeds.remaining(), 1LL, "剩余数错误");
+        assert_equal(seeds.next(), 15LL, "块末尾错误");
+        assert_equal(seeds.peek(), 24LL, "应跳到下一块");
+
+        // 从持久化的位置恢复
+        acm::SeedScheduler restored(0, 1, 2, 8, seeds.position());
+        assert_equal(restored.next(), 24LL, "恢复后种子错误");
+
+        bool thrown = false;
+        try {
+            acm::SeedScheduler bad(0, 2, 2, 8);
+        }
+        catch (const std::runtime_error &) {
+            thrown = true;
+        }
+        assert_true(thrown, "worker编号越界应抛出异常");
+        return "";
+    });
+
+    return suite;
+}
@@ -0,0 +1,122 @@
+#include "test_framework.h"
+#include "SharedLib.h"
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+// 编译共享库形式的测试程序
+static bool build_lib(const std::string &code) {
+    fs::create_directories("./test_shared");
+    {
+        std::ofstream file("./test_shared/gen.cpp");
+        file << code;
+    }
+    return std::system("g++ -Iext ./test_shared/gen.cpp -shared -fPIC -o ./test_shared/gen.so") == 0;
+}
+
+static std::string read_all(const std::string &path) {
+    std::ifstream file(path);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+TestSuite create_sharedlib_tests() {
+    TestSuite suite("SharedLib类");
+
+    suite.add_test("运行并重定向输出", []() -> std::string {
+        assert_true(build_lib(
+            "#include <iostream>\n"
+            "#include <string>\n"
+            "static int counter = 0;\n"
+            "int main(int argc, char **argv) {\n"
+            "    counter++;\n"
+            "    std::cout << argc << ' ' << argv[1] << ' ' << counter << std::endl;\n"
+            "    return std::string(argv[1]) == \"fail\" ? 3 : 0;\n"
+            "}\n"), "共享库编译失败");
+        process::SharedLib lib("./test_shared/gen.so");
+        assert_true(lib.is_open(), "共享库应已载入");
+
+        // 每次运行都从载入时的全局状态开始
+        for (int i = 0; i < 3; i++) {
+            process::Args args("gen");
+            args.add(std::to_string(i));
+            assert_equal(lib.run(args, "./test_shared/out.txt"), process::STOP, "正常退出状态错误");
+            assert_equal(read_all("./test_shared/out.txt"), "2 " + std::to_string(i) + " 1\n", "输出内容错误");
+        }
+
+        process::Args args("gen");
+        args.add("fail");
+        assert_equal(lib.run(args, "./test_shared/out.txt"), process::ERROR, "非零返回值应为ERROR");
+        assert_equal(WEXITSTATUS(lib.get_exit_code()), 3, "退出码错误");
+
+        fs::remove_all("./test_shared");
+        return "";
+    });
+
+    suite.add_test("工作目录与崩溃", []() -> std::string {
+        assert_true(build_lib(
+            "#include <fstream>\n"
+            "#include <csignal>\n"
+            "int main(int argc, char **argv) {\n"
+            "    if (argc > 1) std::raise(SIGSEGV);\n"
+            "    std::ofstream(\"1\") << \"data\";\n"
+            "    return 0;\n"
+            "}\n"), "共享库编译失败");
+        process::SharedLib lib("./test_shared/gen.so");
+        fs::create_directories("./test_shared/work");
+        assert_equal(lib.run(process::Args("gen"), fs::path(), "./test_shared/work"), process::STOP, "运行失败");
+        assert_equal(read_all("./test_shared/work/1"), std::string("data"), "应在工作目录中写文件");
+
+        process::Args args("gen");
+        args.add("crash");
+        assert_equal(lib.run(args), process::RE, "崩溃应为RE");
+
+        fs::remove_all("./test_shared");
+        return "";
+    });
+
+    suite.add_test("常驻服务验证多组输入", []() -> std::string {
+        assert_true(build_lib(
+            "#include \"testlib.h\"\n"
+            "int main(int argc, char *argv[]) {\n"
+            "    registerValidation(argc, argv);\n"
+            "    inf.readInt(1, 100, \"n\");\n"
+            "    inf.readEoln();\n"
+            "    inf.readEof();\n"
+            "    return 0;\n"
+            "}\n"), "共享库编译失败");
+        process::SharedLib lib("./test_shared/gen.so");
+        process::Args args("val");
+        assert_equal(lib.serve(args, "5\n"), process::STOP, "合法输入应通过");
+        assert_equal(lib.serve(args, "100\n"), process::STOP, "常驻进程应继续验证");
+        // 非法输入时testlib退出，常驻进程随之结束
+        assert_equal(lib.serve(args, "101\n"), process::ERROR, "越界输入应被拒绝");
+        assert_equal(lib.serve(args, ""), process::ERROR, "空输入应被拒绝");
+        // 退出后自动重启
+        assert_equal(lib.serve(args, "7\n"), process::STOP, "重启后应继续验证");
+        lib.stop_service();
+        assert_equal(lib.serve(args, "8\n"), process::STOP, "结束后再次调用应重启");
+
+        fs::remove_all("./test_shared");
+        return "";
+    });
+
+    suite.add_test("载入失败", []() -> std::string {
+        process::SharedLib lib;
+        assert_true(!lib.is_open(), "未载入时状态错误");
+        bool thrown = false;
+        try {
+            lib.open("./test_shared_missing.so");
+        }
+        catch (const std::runtime_error &) {
+            thrown = true;
+        }
+        assert_true(thrown && !lib.is_open(), "载入不存在的共享库应抛出异常");
+        return "";
+    });
+
+    return suite;
+}
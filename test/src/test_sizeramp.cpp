@@ -0,0 +1,47 @@
+#include "test_framework.h"
+#include "SizeRamp.h"
+
+TestSuite create_sizeramp_tests() {
+    TestSuite suite("SizeRamp类");
+
+    suite.add_test("几何分档", []() -> std::string {
+        acm::SizeRamp ramp(1, 100000, 6, 10);
+        assert_equal(ramp.buckets(), (size_t)6, "档位数错误");
+        long long expect[] = {1, 10, 100, 1000, 10000, 100000};
+        for (size_t i = 0; i < ramp.buckets(); i++) {
+            assert_equal(ramp.size_of(i), expect[i], "第" + std::to_string(i) + "档规模错误");
+        }
+        // 取整后重复的档位被合并
+        acm::SizeRamp small(1, 3, 8, 10);
+        assert_equal(small.buckets(), (size_t)3, "重复档位应合并");
+        assert_true(!acm::SizeRamp().enabled(), "默认不启用");
+        return "";
+    });
+
+    suite.add_test("从小到大推进并循环", []() -> std::string {
+        acm::SizeRamp ramp(10, 1000, 3, 2);
+        long long order[] = {10, 10, 100, 100, 1000, 1000, 10, 10};
+        for (long long size : order) {
+            assert_equal(ramp.size(), size, "规模顺序错误");
+            ramp.record(0.5);
+        }
+        assert_equal(ramp.count_of(0), 4, "组数统计错误");
+        assert_equal(ramp.time_of(0), 2.0, "耗时统计错误");
+        assert_equal(ramp.remaining(), 2, "剩余组数错误");
+        return "";
+    });
+
+    suite.add_test("参数不合法", []() -> std::string {
+        bool thrown = false;
+        try {
+            acm::SizeRamp ramp(100, 10, 4, 10);
+        }
+        catch (const std::runtime_error &) {
+            thrown = true;
+        }
+        assert_true(thrown, "最大规模小于最小规模应抛出异常");
+        return "";
+    });
+
+    return suite;
+}
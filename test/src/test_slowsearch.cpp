@@ -0,0 +1,69 @@
+#include "test_framework.h"
+#include "SlowSearch.h"
+#include <atomic>
+#include <cmath>
+
+TestSuite create_slowsearch_tests() {
+    TestSuite suite("SlowSearch类");
+
+    suite.add_test("爬向更大的规模", []() -> std::string {
+        // 代价随规模增长，种子只带来少量扰动
+        acm::SlowSearch search([](long long seed, long long size, int) {
+            return size + (seed % 100) / 1000.0;
+        }, 4, 1, 1000, 42);
+        for (int i = 0; i < 30; i++) {
+            search.step();
+        }
+        assert_equal(search.best().size, 1000LL, "应找到规模上限");
+        assert_equal(search.evaluations(), 120LL, "评估次数应为轮数乘线程数");
+        return "";
+    });
+
+    suite.add_test("代价有峰值时停在峰值附近", []() -> std::string {
+        acm::SlowSearch search([](long long, long long size, int) {
+            return 1000.0 - std::abs(size - 300);
+        }, 2, 1, 1000, 7);
+        for (int i = 0; i < 200; i++) {
+            search.step();
+        }
+        assert_true(std::abs(search.best().size - 300) <= 3, "应接近代价最大的规模: " + std::to_string(search.best().size));
+        return "";
+    });
+
+    suite.add_test("不设规模时只换种子", []() -> std::string {
+        acm::SlowSearch search([](long long seed, long long size, int) {
+            assert_equal(size, 0LL, "不设规模时规模应为0");
+            return (double)(seed % 1000);
+        }, 3, 0, 0, 1);
+        double last = -1;
+        for (int i = 0; i < 20; i++) {
+            double cost = search.step().cost;
+            assert_true(cost >= last, "最慢代价不应下降");
+            last = cost;
+        }
+        assert_true(last > 900, "随机种子应找到较慢的输入");
+        return "";
+    });
+
+    suite.add_test("无效候选不会成为最慢", []() -> std::string {
+        std::atomic<int> calls{ 0 };
+        acm::SlowSearch search([&](long long, long long, int) {
+            calls++;
+            return -1.0;
+        }, 2, 1, 10, 3);
+        search.step();
+        assert_true(search.best().cost < 0, "都无效时不应有最慢候选");
+        assert_equal(calls.load(), 2, "每轮应评估每个候选");
+        bool thrown = false;
+        try {
+            acm::SlowSearch bad([](long long, long long, int) { return 0.0; }, 1, 5, 2);
+        }
+        catch (const std::exception &) {
+            thrown = true;
+        }
+        assert_true(thrown, "非法规模范围应抛出异常");
+        return "";
+    });
+
+    return suite;
+}
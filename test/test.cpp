@@ -10,6 +10,23 @@ extern TestSuite create_process_complex_tests();
 extern TestSuite create_keycircle_tests();
 extern TestSuite create_judgesign_tests();
 extern TestSuite create_pipe_tests();  // 添加Pipe测试套件
+extern TestSuite create_compare_tests();
+extern TestSuite create_mappedfile_tests();
+extern TestSuite create_sharedlib_tests();
+extern TestSuite create_seedscheduler_tests();
+extern TestSuite create_hash_tests();
+extern TestSuite create_sizeramp_tests();
+extern TestSuite create_bandit_tests();
+extern TestSuite create_minimizer_tests();
+extern TestSuite create_failurebuckets_tests();
+extern TestSuite create_coverage_tests();
+extern TestSuite create_slowsearch_tests();
+extern TestSuite create_outputcache_tests();
+extern TestSuite create_autoconfig_tests();
+extern TestSuite create_jsonlstore_tests();
+extern TestSuite create_corpus_tests();
+extern TestSuite create_pack_tests();
+extern TestSuite create_genbatch_tests();
 
 int main(int argc, char** argv) {
     std::cout << "==================================" << std::endl;
@@ -39,6 +56,23 @@ int main(int argc, char** argv) {
     bool run_keycircle=(args[1]=="keycircle")||run_all;
     bool run_judgesign=(args[1]=="judgesign")||run_all;
     bool run_pipe=(args[1]=="pipe")||run_all;
+    bool run_compare=(args[1]=="compare")||run_all;
+    bool run_mappedfile=(args[1]=="mappedfile")||run_all;
+    bool run_sharedlib=(args[1]=="sharedlib")||run_all;
+    bool run_seedscheduler=(args[1]=="seedscheduler")||run_all;
+    bool run_hash=(args[1]=="hash")||run_all;
+    bool run_sizeramp=(args[1]=="sizeramp")||run_all;
+    bool run_bandit=(args[1]=="bandit")||run_all;
+    bool run_minimizer=(args[1]=="minimizer")||run_all;
+    bool run_failurebuckets=(args[1]=="failurebuckets")||run_all;
+    bool run_coverage=(args[1]=="coverage")||run_all;
+    bool run_slowsearch=(args[1]=="slowsearch")||run_all;
+    bool run_outputcache=(args[1]=="outputcache")||run_all;
+    bool run_autoconfig=(args[1]=="autoconfig")||run_all;
+    bool run_jsonlstore=(args[1]=="jsonlstore")||run_all;
+    bool run_corpus=(args[1]=="corpus")||run_all;
+    bool run_pack=(args[1]=="pack")||run_all;
+    bool run_genbatch=(args[1]=="genbatch")||run_all;
 
     // 添加要运行的测试套件
     if (run_args) {
@@ -74,6 +108,74 @@ int main(int argc, char** argv) {
         manager.add_suite(create_pipe_tests());  // 添加Pipe测试套件
     }
 
+    if (run_compare) {
+        manager.add_suite(create_compare_tests());
+    }
+
+    if (run_mappedfile) {
+        manager.add_suite(create_mappedfile_tests());
+    }
+
+    if (run_sharedlib) {
+        manager.add_suite(create_sharedlib_tests());
+    }
+
+    if (run_seedscheduler) {
+        manager.add_suite(create_seedscheduler_tests());
+    }
+
+    if (run_hash) {
+        manager.add_suite(create_hash_tests());
+    }
+
+    if (run_sizeramp) {
+        manager.add_suite(create_sizeramp_tests());
+    }
+
+    if (run_bandit) {
+        manager.add_suite(create_bandit_tests());
+    }
+
+    if (run_minimizer) {
+        manager.add_suite(create_minimizer_tests());
+    }
+
+    if (run_failurebuckets) {
+        manager.add_suite(create_failurebuckets_tests());
+    }
+
+    if (run_coverage) {
+        manager.add_suite(create_coverage_tests());
+    }
+
+    if (run_slowsearch) {
+        manager.add_suite(create_slowsearch_tests());
+    }
+
+    if (run_outputcache) {
+        manager.add_suite(create_outputcache_tests());
+    }
+
+    if (run_autoconfig) {
+        manager.add_suite(create_autoconfig_tests());
+    }
+
+    if (run_jsonlstore) {
+        manager.add_suite(create_jsonlstore_tests());
+    }
+
+    if (run_corpus) {
+        manager.add_suite(create_corpus_tests());
+    }
+
+    if (run_pack) {
+        manager.add_suite(create_pack_tests());
+    }
+
+    if (run_genbatch) {
+        manager.add_suite(create_genbatch_tests());
+    }
+
     // 运行所有测试
     bool all_passed = manager.run_all();
 